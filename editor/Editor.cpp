@@ -61,9 +61,15 @@ DrEditor::~DrEditor() { }
 //##    Callbacks
 //####################################################################################
 // Sets shader texture to passed in image texture
+//      Uses mesh built while image was loading if there is one
 void setMeshTexture(std::shared_ptr<DrImage>& image) {
     DrEditor* editor = dynamic_cast<DrEditor*>(App());
-    editor->calculateMesh(true);
+    std::shared_ptr<DrMesh> mesh = editor->takeBuiltMesh(image.get());
+    if (mesh != nullptr) {
+        editor->uploadMesh(mesh, true);
+    } else {
+        editor->calculateMesh(true);
+    }
     App()->renderContext()->bindings.fs_images[SLOT_tex].id = image->gpuID();
 }
 
@@ -80,9 +86,9 @@ void DrEditor::onCreate() {
     // // Create entity
     // int entity = ecs()->createEntity();
     // Transform2D et { };
-    //     et.position =   std::vector<double>({1.0, 2.0, 3.0});
-    //     et.rotation =   std::vector<double>({4.0, 5.0, 6.0});
-    //     et.scale_xyz =  std::vector<double>({7.0, 8.0, 9.0});
+    //     et.position[0] =  1.0;   et.position[1] =  2.0;  et.position[2] =  3.0;
+    //     et.rotation[0] =  4.0;   et.rotation[1] =  5.0;  et.rotation[2] =  6.0;
+    //     et.scale_xyz[0] = 7.0;   et.scale_xyz[1] = 8.0;  et.scale_xyz[2] = 9.0;
     // ecs()->addComponent(entity, et);
 
     // // Component Iterate
@@ -100,14 +106,14 @@ void DrEditor::onCreate() {
 
     //         // Get Position
     //         TypeData member_data = MemberData(component_hash_id, "position");
-    //         std::vector<double>& pos = ClassMember<std::vector<double>>(component, member_data);
+    //         double (&pos)[3] = ClassMember<double[3]>(component, member_data);
     //         std::cout << "    " << member_data.title << " - X: " << pos[0] << ", Y: " << pos[1] << ", Z: " << pos[2] << std::endl;
 
     //         // Set Test
-    //         pos = { 23.0, 43.2, 99.0 };
+    //         pos[0] = 23.0;  pos[1] = 43.2;  pos[2] = 99.0;
 
     //         // Check Set
-    //         std::vector<double> check_pos = ClassMember<std::vector<double>>(component, member_data);
+    //         double (&check_pos)[3] = ClassMember<double[3]>(component, member_data);
     //         std::cout << "  After setting - X: " << check_pos[0] << ", Y: " << check_pos[1] << ", Z: " << check_pos[2] << std::endl;
     //     } else {
     //         std::cout << "---" << std::endl;
@@ -146,35 +152,37 @@ void DrEditor::onCreate() {
     // }
 
     // // Test GetProperty by Index
-    // std::vector<double> rotation = ClassMember<std::vector<double>>(&et, MemberData(et, 1));
+    // double (&rotation)[3] = ClassMember<double[3]>(&et, MemberData(et, 1));
     // std::cout << "Rotation X: " << rotation[0] << ", Rotation Y: " << rotation[1] << ", Rotation Z: " << rotation[2] << std::endl;
 
     // // Test GetProperty by Name
-    // std::vector<double> position = ClassMember<std::vector<double>>(&et, MemberData(et, "position"));
+    // double (&position)[3] = ClassMember<double[3]>(&et, MemberData(et, "position"));
     // std::cout << "Position X: " << position[0] << ", Position Y: " << position[1] << ", Position Z: " << position[2] << std::endl;
 
     // // Test SetProperty by Index
     // std::cout << "Transform 't' variable 'rotation.y' is currently: " << et.rotation[1] << std::endl;
     // std::cout << "  Setting Now..." << std::endl;
-    // ClassMember<std::vector<double>>(&et, MemberData(et, "rotation"))[1] = 189;
+    // ClassMember<double[3]>(&et, MemberData(et, "rotation"))[1] = 189;
     // std::cout << "  'rotation.y' is now: " << et.rotation[1] << std::endl;
 
     // // Test SetProperty by Name
-    // ClassMember<std::vector<double>>(&et, MemberData(et, "position")) = { 56.0, 58.5, 60.2 };
+    // ClassMember<double[3]>(&et, MemberData(et, "position"))[0] = 56.0;
     // std::cout << "Transform2D instance - Position X: " << et.position[0] << ", Position Y: " << et.position[1] << ", Position Z: " << et.position[2] << std::endl;
 
     // #############################################
 
     // Load Images
     for (int i = 0; i < EDITOR_IMAGE_TOTAL; ++i) gui_images.push_back(nullptr);
-    imageManager()->fetchImage({gui_images[EDITOR_IMAGE_WORLD_GRAPH],   (appDirectory() + "assets/toolbar_icons/world_graph.png"),      ATLAS_TYPE_ENGINE, ATLAS_PADDING});
-    imageManager()->fetchImage({gui_images[EDITOR_IMAGE_WORLD_CREATOR], (appDirectory() + "assets/toolbar_icons/world_creator.png"),    ATLAS_TYPE_ENGINE, ATLAS_PADDING});
-    imageManager()->fetchImage({gui_images[EDITOR_IMAGE_UI_CREATOR],    (appDirectory() + "assets/toolbar_icons/ui_creator.png"),       ATLAS_TYPE_ENGINE, ATLAS_PADDING});
+    imageManager()->fetchImages({
+        {gui_images[EDITOR_IMAGE_WORLD_GRAPH],   (appDirectory() + "assets/toolbar_icons/world_graph.png"),      ATLAS_TYPE_ENGINE, ATLAS_PADDING},
+        {gui_images[EDITOR_IMAGE_WORLD_CREATOR], (appDirectory() + "assets/toolbar_icons/world_creator.png"),    ATLAS_TYPE_ENGINE, ATLAS_PADDING},
+        {gui_images[EDITOR_IMAGE_UI_CREATOR],    (appDirectory() + "assets/toolbar_icons/ui_creator.png"),       ATLAS_TYPE_ENGINE, ATLAS_PADDING},
+    });
 
 
     // Initiate Blob Fetch
-    imageManager()->fetchImage({m_image, appDirectory() + "assets/images/blob.png",  ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, false});
-    imageManager()->fetchImage({m_image, appDirectory() + "assets/images/craft.png", ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, false});
+    imageManager()->fetchImage({m_image, appDirectory() + "assets/images/blob.png",  ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, false, false, meshBuilder()});
+    imageManager()->fetchImage({m_image, appDirectory() + "assets/images/craft.png", ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, false, false, meshBuilder()});
     //imageManager()->fetchImage({m_image, "http://github.com/stevinz/extrude/blob/master/assets/blob.png?raw=true", ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, false});
 }
 
@@ -410,7 +418,7 @@ void DrEditor::onEvent(const sapp_event* event) {
         // Load image, apply to mesh and shader afterwards
         bool perform_outline = false;
         bool was_dropped = true;
-        imageManager()->fetchImage({m_image, sapp_get_dropped_file_path(0), ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, perform_outline, was_dropped});
+        imageManager()->fetchImage({m_image, sapp_get_dropped_file_path(0), ATLAS_TYPE_3D_GAME, ATLAS_PADDING, setMeshTexture, perform_outline, was_dropped, meshBuilder()});
     }
 }
 
@@ -418,14 +426,15 @@ void DrEditor::onEvent(const sapp_event* event) {
 //####################################################################################
 //##    Create 3D extrusion
 //####################################################################################
-void DrEditor::calculateMesh(bool reset_position) {
+// Builds mesh for image, cpu only so it is safe to call from worker threads while image is being loaded
+std::shared_ptr<DrMesh> DrEditor::buildMesh(std::shared_ptr<DrImage>& image, int quality, bool wireframe) {
     //##    Level of Detail:
     //##        0.075 = Detailed
     //##        0.250 = Nice
     //##        1.000 = Low poly
     //##       10.000 = Really low poly
     float level_of_detail = 0.6f;
-    switch (m_mesh_quality) {
+    switch (quality) {
         case 0: level_of_detail = 19.200f;  break;
         case 1: level_of_detail =  9.600f;  break;
         case 2: level_of_detail =  4.800f;  break;
@@ -438,29 +447,60 @@ void DrEditor::calculateMesh(bool reset_position) {
     }
 
     // ***** Initialize Mesh
-    if (m_image->outlineRequested()) m_image->outlinePoints(level_of_detail);
-    m_mesh = std::make_shared<DrMesh>();
-
-
-    // !!!!! #TEMP: Size off of atlas
-    //m_mesh->image_size = m_image->bitmap().maxDimension();
-    std::shared_ptr<DrAtlas>& atlas = imageManager()->atlasFromGpuID(m_image->gpuID());
-    m_mesh->image_size = Max(atlas->width, atlas->height);
-    // !!!!! END TEMP
-    m_mesh->wireframe = m_wireframe;
+    if (image->outlineRequested()) image->outlinePoints(level_of_detail);
+    std::shared_ptr<DrMesh> mesh = std::make_shared<DrMesh>();
+    mesh->wireframe = wireframe;
 
 
     // ***** Create Mesh
-    //m_mesh->initializeExtrudedImage(m_image.get(), m_mesh_quality);
-    //m_mesh->initializeTextureQuad();
-    m_mesh->initializeTextureCube();
-    //m_mesh->initializeTextureCone();
+    //mesh->initializeExtrudedImage(image.get(), quality);
+    //mesh->initializeTextureQuad();
+    mesh->initializeTextureCube();
+    //mesh->initializeTextureCone();
 
 
     // ***** Optimize and smooth mesh
-    m_mesh->optimizeMesh();
+    mesh->optimizeMesh();
     // ----- Experimental, doesnt work great -----
-    //m_mesh->smoothMesh();
+    //mesh->smoothMesh();
+    return mesh;
+}
+
+// Returns function that builds mesh of an image on a worker thread (ImageLoadData::prepare), mesh is picked up by setMeshTexture()
+ImageFunction DrEditor::meshBuilder() {
+    int  quality =   m_mesh_quality;
+    bool wireframe = m_wireframe;
+    return [this, quality, wireframe](std::shared_ptr<DrImage>& image) {
+        std::shared_ptr<DrMesh> mesh = buildMesh(image, quality, wireframe);
+        std::lock_guard<std::mutex> lock(m_built_mesh_mutex);
+        m_built_meshes[image.get()] = mesh;
+    };
+}
+
+// Returns mesh built on a worker thread for 'image', nullptr if there isn't one
+std::shared_ptr<DrMesh> DrEditor::takeBuiltMesh(DrImage* image) {
+    std::lock_guard<std::mutex> lock(m_built_mesh_mutex);
+    auto it = m_built_meshes.find(image);
+    if (it == m_built_meshes.end()) return nullptr;
+    std::shared_ptr<DrMesh> mesh = it->second;
+    m_built_meshes.erase(it);
+    return mesh;
+}
+
+// Rebuilds mesh of current image on the frame thread
+void DrEditor::calculateMesh(bool reset_position) {
+    uploadMesh(buildMesh(m_image, m_mesh_quality, m_wireframe), reset_position);
+}
+
+// Makes 'mesh' the current mesh, copies its vertex data into gpu buffers
+void DrEditor::uploadMesh(std::shared_ptr<DrMesh> mesh, bool reset_position) {
+    m_mesh = mesh;
+
+    // !!!!! #TEMP: Size off of atlas
+    //m_mesh->image_size = m_image->bitmap().maxDimension();
+    std::shared_ptr<DrAtlas>& atlas = imageManager()->atlasFromGpuID(m_image->gpuID());
+    m_mesh->image_size = Max(atlas->width, atlas->height);
+    // !!!!! END TEMP
 
 
     // ***** Copy vertex data and set into state buffer
@@ -11,6 +11,10 @@
 #define DR_EDITOR_H
 
 // Includes
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "engine/app/resources/ImageManager.h"
 #include "engine/app/App.h"
 #include "editor/Types.h"
 
@@ -52,6 +56,8 @@ public:
     std::shared_ptr<DrMesh>     m_mesh              { std::make_shared<DrMesh>() };
     std::shared_ptr<DrImage>    m_image             { nullptr };
     int                         m_mesh_quality      { 5 };
+    std::unordered_map<DrImage*, std::shared_ptr<DrMesh>>   m_built_meshes  { };   // Meshes built on worker threads while images load
+    std::mutex                  m_built_mesh_mutex  { };                            // Guards m_built_meshes
 
     // Image Variables
     int                         m_before_keys       { 5 };
@@ -78,7 +84,11 @@ public:
 
 
     // Temp Demo Functions
+    static std::shared_ptr<DrMesh>  buildMesh(std::shared_ptr<DrImage>& image, int quality, bool wireframe);
+    ImageFunction                   meshBuilder();
+    std::shared_ptr<DrMesh>         takeBuiltMesh(DrImage* image);
     void        calculateMesh(bool reset_position);
+    void        uploadMesh(std::shared_ptr<DrMesh> mesh, bool reset_position);
     void        resetPositions();
 
 };
@@ -10,10 +10,12 @@
 #include "engine/app/core/Math.h"
 #include "engine/app/core/Reflect.h"
 #include "engine/app/core/Strings.h"
+#include "engine/app/core/ThreadPool.h"
 #include "engine/app/image/Bitmap.h"
 #include "engine/app/image/Color.h"
 #include "engine/app/image/Filter.h"
 #include "engine/app/image/Image.h"
+#include "engine/app/image/RowBands.h"
 #include "engine/app/imgui/ImMenu.h"
 #include "engine/app/resources/ImageManager.h"
 #include "engine/ecs/Coordinator.h"
@@ -77,8 +79,11 @@ DrApp::DrApp(std::string title, DrColor bg_color, int width, int height) {
 
 // Destructor
 DrApp::~DrApp() {
+    delete m_event_manager;
     delete m_image_manager;
     delete m_context;
+    SetImageThreadPool(nullptr);
+    delete m_thread_pool;
 
     // Mac Menu Bar Cleanup
     ImMenu::MenuShutDown();
@@ -234,8 +239,11 @@ void DrApp::init(void) {
     //####################################################################################
     //##    App Singletons
     //####################################################################################
+    m_event_manager = new DrEventManager();                                             // Event Manager: App wide typed Events (window / input)
     m_image_manager = new DrImageManager();                                             // Image Manager: Helps with image loading / fetching, atlas creation
     m_context = new DrRenderContext(m_bg_color);                                        // Render Context: Handles initial pipeline / bindings
+    m_thread_pool = new DrThreadPool();                                                 // Thread Pool: Worker threads for ECS System updates, background jobs
+    SetImageThreadPool(m_thread_pool);                                                  // Bitmap filters / conversions split rows across Thread Pool
 
 
     // #################### Virtual onCreate() ####################
@@ -251,8 +259,13 @@ void DrApp::frame(void) {
     // Pump the sokol-fetch message queues, and invoke response callbacks
     sfetch_dowork();
 
-    // Check for images to load
+    // Check for images to load, finish images created in the background (gpu upload)
     if (m_image_manager) m_image_manager->processFetchStack();
+    if (m_image_manager) m_image_manager->processUploads();
+
+    // #################### Events ####################
+    // Send window / input Events queued by event() since last frame
+    if (m_event_manager) m_event_manager->dispatchQueued();
 
     // #################### Begin Renderer ####################
     sg_begin_default_pass(&m_context->pass_action, sapp_width(), sapp_height());
@@ -353,6 +366,36 @@ void DrApp::event(const sapp_event* event) {
         simgui_handle_event(event);
     #endif
 
+    // Queue typed window Events, sent at start of next frame()
+    if (m_event_manager) {
+        switch (event->type) {
+            case SAPP_EVENTTYPE_QUIT_REQUESTED:
+                m_event_manager->queue(DrEventWindowQuit { });
+                break;
+            case SAPP_EVENTTYPE_RESIZED:
+                m_event_manager->queue(DrEventWindowResized { event->window_width, event->window_height });
+                break;
+            case SAPP_EVENTTYPE_KEY_DOWN:
+            case SAPP_EVENTTYPE_KEY_UP:
+            case SAPP_EVENTTYPE_CHAR:
+            case SAPP_EVENTTYPE_MOUSE_DOWN:
+            case SAPP_EVENTTYPE_MOUSE_UP:
+            case SAPP_EVENTTYPE_MOUSE_SCROLL:
+            case SAPP_EVENTTYPE_MOUSE_MOVE: {
+                DrEventWindowInput input { };
+                    input.type =        static_cast<std::uint32_t>(event->type);
+                    input.key_code =    (event->type == SAPP_EVENTTYPE_CHAR) ? event->char_code : static_cast<std::uint32_t>(event->key_code);
+                    input.modifiers =   event->modifiers;
+                    input.mouse_x =     event->mouse_x;
+                    input.mouse_y =     event->mouse_y;
+                m_event_manager->queue(input);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
     // #################### Virtual onEvent() ####################
     this->onEvent(event);
 }
@@ -362,6 +405,9 @@ void DrApp::event(const sapp_event* event) {
 //##    Sokol App Events - cleanup (shutdown)
 //####################################################################################
 void DrApp::cleanup(void) {
+    // #################### Finish Background Image Jobs ####################
+    if (m_image_manager) m_image_manager->waitForJobs();
+
     // #################### Virtual onDestroy() ####################
     this->onDestroy();
 
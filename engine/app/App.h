@@ -53,8 +53,10 @@
 
 // Forward Declarations
 class DrApp;
+class DrEventManager;
 class DrImageManager;
 class DrRenderContext;
+class DrThreadPool;
 
 //####################################################################################
 //##    Global Variable Declarations
@@ -88,8 +90,10 @@ private:
     sg_limits               m_sg_limits;                                            // Sokol gfx runtime information about resource limits
 
     // Modules
+    DrEventManager*         m_event_manager         { nullptr };                    // App wide typed Events, window / input Events are queued here
     DrImageManager*         m_image_manager         { nullptr };                    // Image loading / atlas creation
     DrRenderContext*        m_context               { nullptr };                    // Rendering context for this App (currently built on Sokol_Gfx)
+    DrThreadPool*           m_thread_pool           { nullptr };                    // Worker threads for System updates and other background jobs
 
     // ----- User Data -----
     GameMap                 m_game                  { };                            // Collection of open Game instances
@@ -143,8 +147,10 @@ public:
     void    cleanup(void);                                                          // Linked to internal sokol callbacks
 
     // Singletons
+    DrEventManager*     eventManager()                                  { return m_event_manager; }
     DrImageManager*     imageManager()                                  { return m_image_manager; }
     DrRenderContext*    renderContext()                                 { return m_context; }
+    DrThreadPool*       threadPool()                                    { return m_thread_pool; }
 
     // Local Variable Getters
     std::string         appName()                                       { return m_app_name; }
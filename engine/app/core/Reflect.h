@@ -41,7 +41,8 @@
 //      - No private or protected non-static data members
 //      - No user-declared / user-provided constructors
 //      - No virtual member functions
-//      - No default member initializers (invalid in C++11, okay in C++14 and higher)
+//      - Default member initializers are allowed, but in C++11 they stop the type from being an aggregate
+//        (brace initialization of members, ex: 'Transform2D t { {1, 2, 3} }', needs C++14 or higher)
 //      - See (https://en.cppreference.com/w/cpp/types/is_standard_layout) for more info
 //
 // - BEFORE using reflection, make one call to 'InitializeReflection()'
@@ -186,12 +187,21 @@
 #define SCID_REFLECT_H
 
 // Includes
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 #include <vector>
+#include "ReflectPod.h"
 
 //####################################################################################
 //##    Sample Meta Data Enum
@@ -210,6 +220,7 @@ enum Meta_Data {
 //##    Type Definitions
 //############################
 using TypeHash =        size_t;                                                     // This comes from typeid().hash_code()
+using NameID =          int;                                                        // Index of interned class / member name in SnReflect, -1 if never registered
 using Functions =       std::vector<std::function<void()>>;                         // List of functions
 using IntMap =          std::unordered_map<int, std::string>;                       // Meta data int key map
 using StringMap =       std::map<std::string, std::string>;                         // Meta data string key map
@@ -221,6 +232,7 @@ struct TypeData {
     std::string         name            { "unknown" };                              // Actual struct / class / member variable name
     std::string         title           { "unknown" };                              // Pretty (capitalized, spaced) name for displaying in gui
     TypeHash            type_hash       { 0 };                                      // Underlying typeid().hash_code of actual type
+    NameID              name_id         { -1 };                                     // Interned 'name', set during registration
     IntMap              meta_int_map    { };                                        // Map to hold user meta data by int key
     StringMap           meta_string_map { };                                        // Map to hold user meta data by string key
     // For Class Data
@@ -234,9 +246,25 @@ struct TypeData {
 // Empty TypeData to return by reference on GetTypeData() fail
 static TypeData         unknown_type    { };
 
+// FNV-1a hash of a null terminated name, lets names be looked up without building a std::string
+inline size_t NameHash(const char* name) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (; *name != '\0'; ++name) {
+        hash ^= static_cast<unsigned char>(*name);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
 //####################################################################################
 //##    SnReflect
 //##        Singleton to hold Class / Member reflection and meta data
+//##        - 'classes' / 'members' are filled during registration, class and member names are interned into
+//##          NameIDs as they are registered (stored once in 'names', found by NameHash() of a const char*)
+//##        - Freeze() (called at end of InitializeReflection()) copies them into flat tables used by all
+//##          TypeData fetching: classes in one array, members of each class in one contiguous array (sorted by
+//##          offset), class lookups by TypeHash and by NameID. Tables are never rebuilt, so TypeData references
+//##          stay valid, registering after Freeze() is not allowed
 //############################
 class SnReflect
 {
@@ -244,17 +272,94 @@ public:
     std::unordered_map<TypeHash, TypeData>                  classes     { };        // Holds data about classes / structs
     std::unordered_map<TypeHash, std::map<int, TypeData>>   members     { };        // Holds data about member variables (of classes)
 
+    // Interned names
+    std::deque<std::string>                                 names               { };    // NameID -> name, deque so strings never move
+    std::unordered_map<size_t, NameID>                      name_ids            { };    // NameHash() -> NameID
+
+    // Frozen tables
+    std::vector<TypeData>                                   class_list          { };    // All classes, contiguous
+    std::vector<std::vector<TypeData>>                      member_list         { };    // Members of each class in 'class_list', sorted by offset
+    std::unordered_map<TypeHash, int>                       class_index         { };    // TypeHash -> index in 'class_list'
+    std::vector<int>                                        class_name_index    { };    // NameID -> index in 'class_list', -1 if not a class name
+    bool                                                    frozen              { false };
+
 public:
     void AddClass(TypeData class_data) {
+        assert(frozen == false && "Classes must be registered before InitializeReflection() finishes!");
         assert(class_data.type_hash != 0 && "Class type hash is 0, error in registration?");
+        class_data.name_id = InternName(class_data.name);
         classes[class_data.type_hash] = class_data;
     }
     void AddMember(TypeData class_data, TypeData member_data) {
+        assert(frozen == false && "Members must be registered before InitializeReflection() finishes!");
         assert(class_data.type_hash != 0 && "Class type hash is 0, error in registration?");
         assert(classes.find(class_data.type_hash) != classes.end() && "Class never registered with AddClass before calling AddMember!");
+        member_data.name_id = InternName(member_data.name);
         members[class_data.type_hash][member_data.offset] = member_data;
         classes[class_data.type_hash].member_count = members[class_data.type_hash].size();
     }
+
+    // Returns NameID of 'name', adds it if new
+    NameID InternName(const std::string& name) {
+        size_t hash = NameHash(name.c_str());
+        auto it = name_ids.find(hash);
+        if (it != name_ids.end()) {
+            assert(names[it->second] == name && "Reflected names have same hash, rename one of them!");
+            return it->second;
+        }
+        names.push_back(name);
+        name_ids[hash] = static_cast<NameID>(names.size() - 1);
+        return name_ids[hash];
+    }
+
+    // Returns NameID of 'name', -1 if no class / member was registered with it
+    NameID FindName(const char* name) const {
+        auto it = name_ids.find(NameHash(name));
+        if (it == name_ids.end() || strcmp(names[it->second].c_str(), name) != 0) return -1;
+        return it->second;
+    }
+
+    // Builds flat lookup tables from registered classes / members, called once
+    void Freeze() {
+        assert(frozen == false && "Reflection tables already built!");
+        class_list.reserve(classes.size());
+        member_list.reserve(classes.size());
+        class_name_index.assign(names.size(), -1);
+        for (auto& class_pair : classes) {
+            int index = static_cast<int>(class_list.size());
+            class_list.push_back(class_pair.second);
+            class_index[class_pair.first] = index;
+            class_name_index[class_pair.second.name_id] = index;
+            member_list.push_back(std::vector<TypeData>());
+            for (auto& member_pair : members[class_pair.first]) {
+                member_list.back().push_back(member_pair.second);
+            }
+        }
+        frozen = true;
+    }
+
+    // Returns index of class in 'class_list', -1 if not registered
+    int FindClass(TypeHash class_hash) const {
+        assert(frozen && "Call InitializeReflection() before fetching TypeData!");
+        auto it = class_index.find(class_hash);
+        return (it == class_index.end()) ? -1 : it->second;
+    }
+    int FindClass(const char* class_name) const {
+        assert(frozen && "Call InitializeReflection() before fetching TypeData!");
+        NameID name_id = FindName(class_name);
+        return (name_id < 0) ? -1 : class_name_index[name_id];
+    }
+
+    // Returns index of member in 'member_list[class_index]', -1 if class has no member with that name
+    int FindMember(int class_index, const char* member_name) const {
+        NameID name_id = FindName(member_name);
+        if (name_id < 0) return -1;
+        const std::vector<TypeData>& class_members = member_list[class_index];
+        for (size_t i = 0; i < class_members.size(); ++i) {
+            if (class_members[i].name_id == name_id) return static_cast<int>(i);
+        }
+        return -1;
+    }
 };
 
 //####################################################################################
@@ -304,25 +409,20 @@ void RegisterMember(TypeData class_data, TypeData member_data) {
 //##    Reflection TypeData Fetching
 //############################
 // #################### Class Data Fetching ####################
+// Class TypeData fetching from passed in class TypeHash
+TypeData& ClassData(TypeHash class_hash);
 // Class TypeData fetching by actual class type
 template<typename T>
 TypeData& ClassData() {
-    TypeHash class_hash = typeid(T).hash_code();
-    if (g_reflect->classes.find(class_hash) != g_reflect->classes.end()) {
-        return g_reflect->classes[class_hash];
-    } else {
-        return unknown_type;
-    }
+    return ClassData(TypeHashID<T>());
 }
 // Class TypeData fetching from passed in class instance
 template<typename T>
 TypeData& ClassData(T& class_instance) {
     return ClassData<T>();
 }
-// Class TypeData fetching from passed in class TypeHash
-TypeData& ClassData(TypeHash class_hash);
 // Class TypeData fetching from passed in class name
-TypeData& ClassData(std::string class_name);
+TypeData& ClassData(const std::string& class_name);
 TypeData& ClassData(const char* class_name);
 
 // #################### Member Data Fetching ####################
@@ -342,17 +442,26 @@ TypeData& MemberData(T& class_instance, int member_index) {
 
 // -------------------------    By Name  -------------------------
 // Member TypeData fetching by member variable Name and class TypeHash
-TypeData& MemberData(TypeHash class_hash, std::string member_name);
+TypeData& MemberData(TypeHash class_hash, const char* member_name);
+TypeData& MemberData(TypeHash class_hash, const std::string& member_name);
 // Member TypeData fetching by member variable Name and class name
 template<typename T>
-TypeData& MemberData(std::string member_name) {
+TypeData& MemberData(const char* member_name) {
     return MemberData(TypeHashID<T>(), member_name);
 }
+template<typename T>
+TypeData& MemberData(const std::string& member_name) {
+    return MemberData(TypeHashID<T>(), member_name.c_str());
+}
 // Member TypeData fetching by member variable name and class instance
 template<typename T>
-TypeData& MemberData(T& class_instance, std::string member_name) {
+TypeData& MemberData(T& class_instance, const char* member_name) {
     return MemberData<T>(member_name);
 }
+template<typename T>
+TypeData& MemberData(T& class_instance, const std::string& member_name) {
+    return MemberData<T>(member_name.c_str());
+}
 
 // #################### Member Variable Fetching ####################
 // NOTES:
@@ -407,7 +516,7 @@ ReturnType& ClassMember(void* class_ptr, TypeData& member_data) {
 		mbrs[member_index] = TypeData(); \
 		mbrs[member_index].name = #MEMBER; \
         mbrs[member_index].index = member_index; \
-		mbrs[member_index].type_hash = typeid(T::MEMBER).hash_code(); \
+		mbrs[member_index].type_hash = typeid(decltype(T::MEMBER)).hash_code(); \
 		mbrs[member_index].offset = offsetof(T, MEMBER); \
 		mbrs[member_index].size = sizeof(T::MEMBER); \
 		mbrs[member_index].title = #MEMBER; \
@@ -455,6 +564,9 @@ void InitializeReflection() {
         g_register_list[func]();
     }
     g_register_list.clear();        // Clean up
+
+    // Build flat lookup tables
+    g_reflect->Freeze();
 }
 
 // Used in registration macros to automatically create nice display name from class / member variable names
@@ -497,39 +609,36 @@ void RegisterMember(TypeData class_data, TypeData member_data) {
 // ########## Class Data Fetching ##########
 // Class TypeData fetching from passed in class TypeHash
 TypeData& ClassData(TypeHash class_hash) {
-    for (auto& pair : g_reflect->classes) {
-        if (pair.first == class_hash) return pair.second;
-    }
-    return unknown_type;
-}
-// Class TypeData fetching from passed in class name
-TypeData& ClassData(std::string class_name) {
-    for (auto& pair : g_reflect->classes) {
-        if (pair.second.name == class_name) return pair.second;
-    }
-    return unknown_type;
+    int class_index = g_reflect->FindClass(class_hash);
+    return (class_index < 0) ? unknown_type : g_reflect->class_list[class_index];
 }
 // Class TypeData fetching from passed in class name
 TypeData& ClassData(const char* class_name) {
-    return ClassData(std::string(class_name));
+    int class_index = g_reflect->FindClass(class_name);
+    return (class_index < 0) ? unknown_type : g_reflect->class_list[class_index];
+}
+TypeData& ClassData(const std::string& class_name) {
+    return ClassData(class_name.c_str());
 }
 
 // ########## Member Data Fetching ##########
 // Member TypeData fetching by member variable index and class TypeHash
 TypeData& MemberData(TypeHash class_hash, int member_index) {
-    int count = 0;
-    for (auto& member : g_reflect->members[class_hash]) {
-        if (count == member_index) return member.second;
-        ++count;
-    }
-    return unknown_type;
+    int class_index = g_reflect->FindClass(class_hash);
+    if (class_index < 0) return unknown_type;
+    std::vector<TypeData>& class_members = g_reflect->member_list[class_index];
+    if (member_index < 0 || member_index >= static_cast<int>(class_members.size())) return unknown_type;
+    return class_members[member_index];
 }
 // Member TypeData fetching by member variable name and class TypeHash
-TypeData& MemberData(TypeHash class_hash, std::string member_name) {
-    for (auto& member : g_reflect->members[class_hash]) {
-        if (member.second.name == member_name) return member.second;
-    }
-    return unknown_type;
+TypeData& MemberData(TypeHash class_hash, const char* member_name) {
+    int class_index = g_reflect->FindClass(class_hash);
+    if (class_index < 0) return unknown_type;
+    int member_index = g_reflect->FindMember(class_index, member_name);
+    return (member_index < 0) ? unknown_type : g_reflect->member_list[class_index][member_index];
+}
+TypeData& MemberData(TypeHash class_hash, const std::string& member_name) {
+    return MemberData(class_hash, member_name.c_str());
 }
 
 //####################################################################################
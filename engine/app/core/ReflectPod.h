@@ -0,0 +1,90 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_REFLECT_POD_H
+#define DR_REFLECT_POD_H
+
+// Includes
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+
+//####################################################################################
+//##    Compile Time Reflection
+//##        Member layout of trivially copyable (plain old data) types, built at compile time into a
+//##        constant table, no registration or g_reflect lookups needed. Can be used alongside runtime
+//##        registration in Reflect.h (which still provides class names, titles / meta data for the editor)
+//##
+//##        - Registering a Component with the ECS stores its table in DrComponentInfo::members, scene
+//##          serialization and undo diffing use it in place of runtime member lookups
+//##
+//##            REFLECT_POD(Transform2D)
+//##                REFLECT_POD_MEMBER(position)
+//##                REFLECT_POD_MEMBER(rotation)
+//##            REFLECT_POD_END()
+//##
+//##            for (int m = 0; m < PodMemberCount<Transform2D>(); ++m) {
+//##                const PodMemberData& member = PodMembers<Transform2D>()[m];
+//##                ...member.name, member.offset, member.size
+//##            }
+//############################
+struct PodMemberData {
+    const char*     name;                                                           // Member variable name
+    size_t          offset;                                                         // Char* offset of member variable within parent class / struct
+    size_t          size;                                                           // Size of actual type of member variable
+};
+
+// Types without REFLECT_POD have no compile time member table
+template <typename T>
+struct PodReflection {
+    static constexpr bool reflected = false;
+    static const PodMemberData* members(int& count) { count = 0; return nullptr; }
+};
+
+// Returns true if type was registered with REFLECT_POD
+template <typename T>
+constexpr bool IsPodReflected() { return PodReflection<T>::reflected; }
+
+// Returns compile time member table, sorted in declaration order
+template <typename T>
+const PodMemberData* PodMembers() { int count; return PodReflection<T>::members(count); }
+
+template <typename T>
+int PodMemberCount() { int count; PodReflection<T>::members(count); return count; }
+
+// Returns member variable of 'class_instance' described by compile time member data
+template<typename ReturnType, typename T>
+ReturnType& PodMember(T& class_instance, const PodMemberData& member_data) {
+    assert(sizeof(ReturnType) == member_data.size && "Did not request correct return type!");
+    return *(reinterpret_cast<ReturnType*>(reinterpret_cast<char*>(&class_instance) + member_data.offset));
+}
+
+// Compile time registration macros
+#define REFLECT_POD(TYPE) \
+    template <> struct PodReflection<TYPE> { \
+        using T = TYPE; \
+        static_assert(std::is_trivially_copyable<TYPE>::value, #TYPE " is not trivially copyable!"); \
+        static_assert(std::is_standard_layout<TYPE>::value, #TYPE " is not standard layout!"); \
+        static constexpr bool reflected = true; \
+        static const PodMemberData* members(int& count) { \
+            static constexpr PodMemberData member_list[] = {
+
+#define REFLECT_POD_MEMBER(MEMBER) \
+                { #MEMBER, offsetof(T, MEMBER), sizeof(T::MEMBER) },
+
+#define REFLECT_POD_END() \
+            }; \
+            count = static_cast<int>(sizeof(member_list) / sizeof(PodMemberData)); \
+            return member_list; \
+        } \
+    };
+
+
+#endif  // DR_REFLECT_POD_H
@@ -7,6 +7,7 @@
 // @source      https://github.com/scidian/eyedrop
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
+#include <algorithm>
 #include <ctype.h>
 #include "engine/app/core/Strings.h"
 
@@ -0,0 +1,155 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include "ThreadPool.h"
+
+// Pool / job queue owned by current thread, only set on worker threads
+static thread_local DrThreadPool*   l_pool =        nullptr;
+static thread_local int             l_queue_index = -1;
+
+
+//####################################################################################
+//##    Constructor / Destructor
+//####################################################################################
+DrThreadPool::DrThreadPool(int thread_count) {
+    #if defined(DROP_TARGET_HTML5)
+        thread_count = 0;                                                           // No threads without emscripten pthread support
+    #else
+        if (thread_count < 0) {
+            int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+            thread_count = (hardware_threads > 1) ? (hardware_threads - 1) : 0;
+        }
+    #endif
+
+    // Create queues first so workers can steal from any of them as soon as they start
+    for (int i = 0; i < thread_count + 1; ++i) {
+        m_queues.push_back(std::unique_ptr<DrJobQueue>(new DrJobQueue()));
+    }
+    for (int i = 0; i < thread_count; ++i) {
+        m_threads.push_back(std::thread(&DrThreadPool::workerLoop, this, i));
+    }
+}
+
+DrThreadPool::~DrThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+
+//####################################################################################
+//##    Jobs
+//####################################################################################
+// Adds job to pool, increments 'counter' until job is finished
+void DrThreadPool::submit(std::function<void()> job, DrJobCounter* counter) {
+    if (counter) counter->m_count.fetch_add(1);
+
+    // Workers push to their own queue, other threads spread jobs across worker queues
+    int queue_index = (l_pool == this) ? l_queue_index : -1;
+    if (queue_index < 0) {
+        queue_index = (m_threads.size() > 0) ? static_cast<int>(m_next_queue.fetch_add(1) % m_threads.size()) : static_cast<int>(m_queues.size() - 1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue_index]->mutex);
+        m_queues[queue_index]->jobs.push_back({ std::move(job), counter });
+    }
+    bool waiting = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_pending.fetch_add(1);
+        waiting = (m_waiting > 0);
+    }
+    m_wake.notify_one();
+    if (waiting) m_job_done.notify_all();                                           // Threads in wait() can help run new job
+}
+
+// Helps run jobs until all jobs of 'counter' are finished
+void DrThreadPool::wait(DrJobCounter& counter) {
+    while (counter.done() == false) {
+        DrJob job;
+        if (findJob(job)) {
+            runJob(job);
+            continue;
+        }
+
+        // Nothing left to steal, sleep until a job finishes or a new job is submitted
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        ++m_waiting;
+        m_job_done.wait(lock, [this, &counter]() { return (counter.done() || m_pending.load() > 0); });
+        --m_waiting;
+    }
+}
+
+// Splits [0, count) into batches of 'batch_size', returns when all batches are finished
+void DrThreadPool::parallelFor(int count, int batch_size, std::function<void(int begin, int end)> func) {
+    if (count <= 0) return;
+    if (batch_size < 1) batch_size = 1;
+    DrJobCounter counter;
+    for (int begin = 0; begin < count; begin += batch_size) {
+        int end = (begin + batch_size < count) ? (begin + batch_size) : count;
+        submit([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+    wait(counter);
+}
+
+// Pops newest job from own queue, otherwise steals oldest job from another queue
+bool DrThreadPool::findJob(DrJob& job) {
+    int queue_count = static_cast<int>(m_queues.size());
+    int own = (l_pool == this) ? l_queue_index : (queue_count - 1);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[own]->mutex);
+        if (m_queues[own]->jobs.empty() == false) {
+            job = std::move(m_queues[own]->jobs.back());
+            m_queues[own]->jobs.pop_back();
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    }
+    for (int i = 1; i < queue_count; ++i) {
+        DrJobQueue& victim = *m_queues[(own + i) % queue_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty() == false) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs job, decrements counter
+void DrThreadPool::runJob(DrJob& job) {
+    job.func();
+    if (job.counter && job.counter->m_count.fetch_sub(1) == 1) {
+        // Last job of counter, lock so a thread about to sleep in wait() can't miss the wake up
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        if (m_waiting > 0) m_job_done.notify_all();
+    }
+}
+
+// Worker thread main loop, sleeps when there is no work
+void DrThreadPool::workerLoop(int index) {
+    l_pool = this;
+    l_queue_index = index;
+    while (m_stop == false) {
+        DrJob job;
+        if (findJob(job)) {
+            runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this]() { return (m_stop || m_pending.load() > 0); });
+    }
+}
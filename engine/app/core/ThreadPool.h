@@ -0,0 +1,93 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_THREAD_POOL_H
+#define DR_THREAD_POOL_H
+
+// Includes
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Forward Declarations
+class DrThreadPool;
+
+
+//####################################################################################
+//##    DrJobCounter
+//##        Tracks number of unfinished jobs submitted with it, pass to DrThreadPool::wait()
+//############################
+class DrJobCounter
+{
+    friend class DrThreadPool;
+private:
+    std::atomic<int>    m_count         { 0 };                                      // Jobs submitted and not yet finished
+public:
+    bool                done() const    { return m_count.load() == 0; }
+};
+
+
+//####################################################################################
+//##    DrThreadPool
+//##        Work stealing thread pool, each worker has its own job queue and steals from other queues when empty
+//##        - Jobs submitted from a worker go to that worker's queue (good locality for jobs that spawn jobs)
+//##        - wait() runs pending jobs on the calling thread, so a pool with zero workers still works (ex: Html5),
+//##          once there is nothing left to steal it sleeps until a job finishes or a new job is submitted
+//############################
+class DrThreadPool
+{
+public:
+    // Constructor / Destructor
+    DrThreadPool(int thread_count = -1);                                            // -1 uses (hardware threads - 1)
+    ~DrThreadPool();
+
+private:
+    // #################### LOCAL STRUCTS ####################
+    struct DrJob {
+        std::function<void()>   func;                                               // Work to run
+        DrJobCounter*           counter;                                            // Counter to decrement when finished, can be nullptr
+    };
+    struct DrJobQueue {
+        std::mutex              mutex;
+        std::deque<DrJob>       jobs;
+    };
+
+    // #################### VARIABLES ####################
+    std::vector<std::thread>                    m_threads       { };                // Worker threads
+    std::vector<std::unique_ptr<DrJobQueue>>    m_queues        { };                // One queue per worker, plus one shared by non worker threads
+    std::atomic<bool>                           m_stop          { false };          // Signals workers to exit
+    std::atomic<int>                            m_pending       { 0 };              // Jobs waiting in queues
+    std::atomic<unsigned>                       m_next_queue    { 0 };              // Round robin queue for non worker submits
+    std::mutex                                  m_sleep_mutex   { };                // Guards sleeping workers
+    std::condition_variable                     m_wake          { };                // Wakes sleeping workers
+    std::condition_variable                     m_job_done      { };                // Wakes threads blocked in wait()
+    int                                         m_waiting       { 0 };              // Threads blocked in wait(), guarded by 'm_sleep_mutex'
+
+public:
+    // #################### FUNCTIONS ####################
+    int         threadCount() const     { return static_cast<int>(m_threads.size()); }
+
+    // Jobs
+    void        submit(std::function<void()> job, DrJobCounter* counter = nullptr); // Adds job to pool, increments 'counter' until job is finished
+    void        wait(DrJobCounter& counter);                                        // Helps run jobs until all jobs of 'counter' are finished
+    void        parallelFor(int count, int batch_size, std::function<void(int begin, int end)> func);  // Splits [0, count) into batches, returns when all are finished
+
+private:
+    bool        findJob(DrJob& job);                                                // Pops job from own queue, or steals from another
+    void        runJob(DrJob& job);                                                 // Runs job, decrements counter
+    void        workerLoop(int index);                                              // Worker thread main loop
+
+};
+
+#endif  // DR_THREAD_POOL_H
@@ -13,6 +13,7 @@
 //      https://www.geeksforgeeks.org/how-to-check-if-a-given-point-lies-inside-a-polygon/
 //
 //
+#include <algorithm>
 #include <math.h>
 
 #include "../core/Math.h"
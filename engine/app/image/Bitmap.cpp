@@ -7,6 +7,7 @@
 // @source      https://github.com/scidian/eyedrop
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
+#include <cstring>
 #include "3rd_party/stb/stb_image.h"
 #include "3rd_party/stb/stb_image_resize.h"
 #include "3rd_party/stb/stb_image_write.h"
@@ -17,6 +18,7 @@
 #include "../geometry/Rect.h"
 #include "Bitmap.h"
 #include "Color.h"
+#include "RowBands.h"
 
 
 //####################################################################################
@@ -44,11 +46,13 @@ DrBitmap::DrBitmap(const DrBitmap& bitmap, Bitmap_Format desired_format) :
         data.resize(width * height * bitmap.channels);                                              // Resize data vector
         memcpy(&data[0], &bitmap.data[0], data.size());                                             // Copy data
     } else {
-        for (int x = 0; x < bitmap.width; ++x) {
-            for (int y = 0; y < bitmap.height; ++y) {
-                this->setPixel(x, y, bitmap.getPixel(x, y));
+        ForEachRowBand(bitmap.width, bitmap.height, [&](int first_row, int end_row) {
+            for (int y = first_row; y < end_row; ++y) {
+                for (int x = 0; x < bitmap.width; ++x) {
+                    this->setPixel(x, y, bitmap.getPixel(x, y));
+                }
             }
-        }
+        });
     }
 }
 
@@ -155,6 +159,15 @@ void DrBitmap::clearPixels() {
     std::fill(data.begin(), data.end(), 0);
 }
 
+// Exchanges contents with 'other' without copying pixel data
+void DrBitmap::swap(DrBitmap& other) {
+    std::swap(format,   other.format);
+    std::swap(channels, other.channels);
+    std::swap(width,    other.width);
+    std::swap(height,   other.height);
+    data.swap(other.data);
+}
+
 // !!!!! #WARNING: No out of bounds checks are done here for speed!!
 DrColor DrBitmap::getPixel(int x, int y) const {
     size_t index = (y * this->width * channels) + (x * channels);
@@ -185,19 +198,21 @@ void DrBitmap::setPixel(int x, int y, DrColor color) {
 //##    Testing Alpha
 //####################################################################################
 void DrBitmap::fuzzyAlpha() {
-    for (int x = 0; x < width; ++x) {
-        for (int y = 0; y < height; ++y) {
-            DrColor color = getPixel(x, y);
-            if ((color.red() <  10 && color.green() <  10 && color.blue() <  10) ||
-                (color.red() > 245 && color.green() > 245 && color.blue() > 245)) {
-                switch (format) {
-                    case DROP_BITMAP_FORMAT_GRAYSCALE:  color.setRgbF(0, 0, 0, 0);
-                    case DROP_BITMAP_FORMAT_ARGB:       color.setAlpha(0);
+    ForEachRowBand(width, height, [this](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            for (int x = 0; x < width; ++x) {
+                DrColor color = getPixel(x, y);
+                if ((color.red() <  10 && color.green() <  10 && color.blue() <  10) ||
+                    (color.red() > 245 && color.green() > 245 && color.blue() > 245)) {
+                    switch (format) {
+                        case DROP_BITMAP_FORMAT_GRAYSCALE:  color.setRgbF(0, 0, 0, 0);
+                        case DROP_BITMAP_FORMAT_ARGB:       color.setAlpha(0);
+                    }
+                    setPixel(x, y, color);
                 }
-                setPixel(x, y, color);
             }
         }
-    }
+    });
 }
 
 
@@ -255,17 +270,21 @@ void DrBitmap::loadFromMemory(const unsigned char* from_data, const int& number_
 // Aligns pixel format (stb ABGR vs QImage ARGB) for stbi_write
 void DrBitmap::saveFormat(std::vector<unsigned char>& formatted) {
     formatted.resize(width * height * channels);
-    for (int x = 0; x < width; ++x) {
-        for (int y = 0; y < height; ++y) {
-            DrColor pixel = getPixel(x, y);
-
-            size_t index = (y * width * channels) + (x * channels);
-            formatted[index] =   pixel.red();
-            formatted[index+1] = pixel.green();
-            formatted[index+2] = pixel.blue();
-            formatted[index+3] = pixel.alpha();
-        }
+    if (format == DROP_BITMAP_FORMAT_GRAYSCALE) {
+        if (formatted.size() > 0) memcpy(&formatted[0], &data[0], formatted.size());
+        return;
     }
+    ForEachRowBand(width, height, [&](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            size_t index = static_cast<size_t>(y) * width * channels;
+            for (int x = 0; x < width; ++x, index += channels) {
+                formatted[index] =   data[index+2];
+                formatted[index+1] = data[index+1];
+                formatted[index+2] = data[index];
+                formatted[index+3] = data[index+3];
+            }
+        }
+    });
 }
 
 int DrBitmap::saveAsBmp(std::string filename) {
@@ -67,6 +67,7 @@ public:
     DrPolygonF  polygon() const;
     DrRect      rect() const;
     void        clearPixels();
+    void        swap(DrBitmap& other);
     DrColor     getPixel(int x, int y) const;
     void        setPixel(int x, int y, DrColor color);
 
@@ -7,6 +7,9 @@
 // @source      https://github.com/scidian/eyedrop
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include "3rd_party/stb/stb_image_write.h"
 #include "../core/Math.h"
 #include "../geometry/Point.h"
@@ -14,14 +17,27 @@
 #include "../geometry/Rect.h"
 #include "Color.h"
 #include "Filter.h"
+#include "FilterKernels.h"
+#include "RowBands.h"
 
 
 //####################################################################################
 //##    Loops through image and changes one pixel at a time based on a
 //##    premultiplied table
+//##        ARGB bitmaps run vectorized kernels directly on pixel data (see FilterKernels.h),
+//##        hue / saturation and grayscale bitmaps go through DrColor one pixel at a time
+//##        Rows are split into bands across the image thread pool (see RowBands.h)
 //####################################################################################
 DrBitmap DrFilter::applySinglePixelFilter(Image_Filter_Type filter, const DrBitmap& from_bitmap, int value) {
     DrBitmap image = from_bitmap;
+    if (image.format == DROP_BITMAP_FORMAT_ARGB && image.channels == 4 && HasFilterKernel(filter)) {
+        unsigned char* pixels = image.data.data();
+        size_t row_pixels = static_cast<size_t>(image.width);
+        ForEachRowBand(image.width, image.height, [=](int first_row, int end_row) {
+            FilterPixels(filter, pixels + (first_row * row_pixels * 4), (end_row - first_row) * row_pixels, value);
+        });
+        return image;
+    }
 
     int table[256];
     for ( int i = 0; i < 256; ++i ) {
@@ -32,55 +48,57 @@ DrBitmap DrFilter::applySinglePixelFilter(Image_Filter_Type filter, const DrBitm
         }
     }
 
-    for (size_t y = 0; y < static_cast<size_t>(image.height); ++y) {
-        for (size_t x = 0; x < static_cast<size_t>(image.width); ++x) {
-
-            // Grab the current pixel color
-            DrColor color = image.getPixel(x, y);
-            DrHsv hsv;
-
-            switch (filter) {
-                case DROP_IMAGE_FILTER_BRIGHTNESS:
-                case DROP_IMAGE_FILTER_CONTRAST:
-                    color.setRed(   table[color.red()]   );
-                    color.setGreen( table[color.green()] );
-                    color.setBlue(  table[color.blue()]  );
-                    break;
-                case DROP_IMAGE_FILTER_SATURATION: {
-                    // !!!!! #NOTE: Some color implementations (like QColor) return -1 if image is grayscale
-                    //              If thats the case give it a default hue of 0 (red) to match shader
-                    //                    int hue = (color.hue() == -1) ? 0 : color.hue();
-                    //                    color.setHsv(hue, Dr::Clamp(color.saturation() + value, 0, 255), color.value(), color.alpha());
-                    break;
-                }
-                case DROP_IMAGE_FILTER_HUE:
-                    hsv = color.getHsv();
-                    hsv.hue = Clamp(hsv.hue + value, -360.0, 360.0);
-                    color.setFromHsv(hsv);
-                    break;
-                case DROP_IMAGE_FILTER_GRAYSCALE: {
-                    double temp = (color.redF() * 0.2126) + (color.greenF() * 0.7152) + (color.blueF() * 0.0722);
-                    color.setRgbF(temp, temp, temp, color.alphaF());
-                    break;
-                }
-                case DROP_IMAGE_FILTER_NEGATIVE:
-                    color.setRgbF(1.0 - color.redF(), 1.0 - color.greenF(), 1.0 - color.blueF(), color.alphaF());
-                    break;
-                case DROP_IMAGE_FILTER_OPACITY:
-                    color.setAlpha( Clamp(color.alpha() + value, 0, 255) );
-                    break;
-                case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA: {
-                    color.setRedF(   color.redF() *   color.alphaF() );
-                    color.setGreenF( color.greenF() * color.alphaF() );
-                    color.setBlueF(  color.blueF() *  color.alphaF() );
-                    break;
+    ForEachRowBand(image.width, image.height, [&](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            for (int x = 0; x < image.width; ++x) {
+
+                // Grab the current pixel color
+                DrColor color = image.getPixel(x, y);
+                DrHsv hsv;
+
+                switch (filter) {
+                    case DROP_IMAGE_FILTER_BRIGHTNESS:
+                    case DROP_IMAGE_FILTER_CONTRAST:
+                        color.setRed(   table[color.red()]   );
+                        color.setGreen( table[color.green()] );
+                        color.setBlue(  table[color.blue()]  );
+                        break;
+                    case DROP_IMAGE_FILTER_SATURATION: {
+                        // !!!!! #NOTE: Some color implementations (like QColor) return -1 if image is grayscale
+                        //              If thats the case give it a default hue of 0 (red) to match shader
+                        //                    int hue = (color.hue() == -1) ? 0 : color.hue();
+                        //                    color.setHsv(hue, Dr::Clamp(color.saturation() + value, 0, 255), color.value(), color.alpha());
+                        break;
+                    }
+                    case DROP_IMAGE_FILTER_HUE:
+                        hsv = color.getHsv();
+                        hsv.hue = Clamp(hsv.hue + value, -360.0, 360.0);
+                        color.setFromHsv(hsv);
+                        break;
+                    case DROP_IMAGE_FILTER_GRAYSCALE: {
+                        double temp = (color.redF() * 0.2126) + (color.greenF() * 0.7152) + (color.blueF() * 0.0722);
+                        color.setRgbF(temp, temp, temp, color.alphaF());
+                        break;
+                    }
+                    case DROP_IMAGE_FILTER_NEGATIVE:
+                        color.setRgbF(1.0 - color.redF(), 1.0 - color.greenF(), 1.0 - color.blueF(), color.alphaF());
+                        break;
+                    case DROP_IMAGE_FILTER_OPACITY:
+                        color.setAlpha( Clamp(color.alpha() + value, 0, 255) );
+                        break;
+                    case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA: {
+                        color.setRedF(   color.redF() *   color.alphaF() );
+                        color.setGreenF( color.greenF() * color.alphaF() );
+                        color.setBlueF(  color.blueF() *  color.alphaF() );
+                        break;
+                    }
                 }
-            }
 
-            // Sets the new pixel color
-            image.setPixel(x, y, color);
+                // Sets the new pixel color
+                image.setPixel(x, y, color);
+            }
         }
-    }
+    });
     return image;
 }
 
@@ -116,15 +134,146 @@ DrBitmap DrFilter::blackAndWhiteFromAlpha(const DrBitmap& bitmap, double alpha_t
     DrBitmap black_white(bitmap, desired_format);
     int alpha_i = static_cast<int>(alpha_tolerance * 255.0);
 
-    for (int x = 0; x < bitmap.width; ++x) {
-        for (int y = 0; y < bitmap.height; ++y) {
-            black_white.setPixel(x, y, ((bitmap.getPixel(x, y).alpha() < alpha_i) ? color1 : color2));
+    ForEachRowBand(bitmap.width, bitmap.height, [&](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            for (int x = 0; x < bitmap.width; ++x) {
+                black_white.setPixel(x, y, ((bitmap.getPixel(x, y).alpha() < alpha_i) ? color1 : color2));
+            }
         }
-    }
+    });
     return black_white;
 }
 
 
+//####################################################################################
+//##    Scanline Fill
+//##        Span based fill shared by floodFill() and fillBorder(). Pixels are compared
+//##        with per byte lookup tables, visited pixels are tracked with a 1 bit mask
+//####################################################################################
+// Inclusive run of filled pixels on one row
+struct DrFillSpan {
+    int     y;
+    int     x1;
+    int     x2;
+};
+
+// Scratch state of a fill, one visited mask can be shared by many fills of the same bitmap
+struct DrScanlineFill {
+    DrBitmap*                   bitmap;
+    unsigned char               accept[4][256];                                 // Per byte of pixel, non zero if byte value matches start color
+    unsigned char               fill[4];                                        // Bytes written to filled pixels
+    bool                        write_fill;                                     // When false bitmap is left untouched
+    bool                        compare_8;                                      // Include diagonal neighbors
+    std::vector<uint64_t>       visited;
+    std::vector<DrPoint>        stack;
+    std::vector<DrFillSpan>     spans;                                          // Spans filled, appended to by every run()
+
+    DrScanlineFill(DrBitmap& bitmap_, DrColor start_color, double tolerance, Flood_Fill_Type type) :
+        bitmap(&bitmap_), write_fill(false), compare_8(type == DROP_FLOOD_FILL_COMPARE_8),
+        visited((static_cast<size_t>(bitmap_.width) * bitmap_.height + 63) / 64, 0) {
+        // Same comparison as IsSameColor(), grayscale bitmaps read their one byte as red, green, blue and alpha
+        for (int i = 0; i < 256; ++i) {
+            unsigned char v = static_cast<unsigned char>(i);
+            DrColor byte(v, v, v, v);
+            if (bitmap->format == DROP_BITMAP_FORMAT_GRAYSCALE) {
+                accept[0][i] = IsSameColor(start_color, byte, tolerance);
+            } else {
+                accept[0][i] = IsCloseTo(start_color.blueF(),  byte.blueF(),  tolerance);
+                accept[1][i] = IsCloseTo(start_color.greenF(), byte.greenF(), tolerance);
+                accept[2][i] = IsCloseTo(start_color.redF(),   byte.redF(),   tolerance);
+                accept[3][i] = IsCloseTo(start_color.alphaF(), byte.alphaF(), tolerance);
+            }
+        }
+    }
+
+    // Bytes of 'color' as stored by bitmap
+    void setFillColor(DrColor color) {
+        DrBitmap one(1, 1, bitmap->format);
+        one.setPixel(0, 0, color);
+        for (int c = 0; c < bitmap->channels; ++c) fill[c] = one.data[c];
+        write_fill = true;
+    }
+
+    bool isVisited(size_t index) const  { return (visited[index >> 6] >> (index & 63)) & 1; }
+
+    bool matches(int x, int y) const {
+        size_t index = static_cast<size_t>(y) * bitmap->width + x;
+        if (isVisited(index)) return false;
+        const unsigned char* pixel = &bitmap->data[index * bitmap->channels];
+        for (int c = 0; c < bitmap->channels; ++c) {
+            if (accept[c][pixel[c]] == 0) return false;
+        }
+        return true;
+    }
+
+    // Fills connected matching pixels starting at (at_x, at_y), returns number of pixels filled
+    int run(int at_x, int at_y) {
+        int width = bitmap->width;
+        int height = bitmap->height;
+        int reach = compare_8 ? 1 : 0;
+        int count = 0;
+        stack.clear();
+        stack.push_back(DrPoint(at_x, at_y));
+        while (stack.empty() == false) {
+            DrPoint seed = stack.back();
+            stack.pop_back();
+            int y = seed.y;
+            if (matches(seed.x, y) == false) continue;
+
+            // Grow span left and right, then fill it
+            int x1 = seed.x, x2 = seed.x;
+            while (x1 > 0         && matches(x1 - 1, y)) --x1;
+            while (x2 < width - 1 && matches(x2 + 1, y)) ++x2;
+            size_t row = static_cast<size_t>(y) * width;
+            for (int x = x1; x <= x2; ++x) {
+                size_t index = row + x;
+                visited[index >> 6] |= (uint64_t(1) << (index & 63));
+                if (write_fill) memcpy(&bitmap->data[index * bitmap->channels], fill, bitmap->channels);
+            }
+            spans.push_back(DrFillSpan { y, x1, x2 });
+            count += (x2 - x1) + 1;
+
+            // Push one seed for each run of matching pixels in rows above and below
+            for (int ny = y - 1; ny <= y + 1; ny += 2) {
+                if (ny < 0 || ny >= height) continue;
+                int start = (x1 - reach > 0) ? (x1 - reach) : 0;
+                int end =   (x2 + reach < width - 1) ? (x2 + reach) : (width - 1);
+                bool in_run = false;
+                for (int x = start; x <= end; ++x) {
+                    bool match = matches(x, ny);
+                    if (match && in_run == false) stack.push_back(DrPoint(x, ny));
+                    in_run = match;
+                }
+            }
+        }
+        return count;
+    }
+};
+
+// Bounding rect of spans
+static DrRect spanRect(const std::vector<DrFillSpan>& spans) {
+    if (spans.empty()) return DrRect(0, 0, 0, 0);
+    int min_x = spans[0].x1, max_x = spans[0].x2;
+    int min_y = spans[0].y,  max_y = spans[0].y;
+    for (auto& span : spans) {
+        if (span.x1 < min_x) min_x = span.x1;
+        if (span.x2 > max_x) max_x = span.x2;
+        if (span.y  < min_y) min_y = span.y;
+        if (span.y  > max_y) max_y = span.y;
+    }
+    return DrRect(min_x, min_y, (max_x - min_x) + 1, (max_y - min_y) + 1);
+}
+
+// Writes 'color' into ARGB 'bitmap' for all spans
+static void paintSpans(DrBitmap& bitmap, const std::vector<DrFillSpan>& spans, DrColor color) {
+    unsigned char bgra[4] = { color.blue(), color.green(), color.red(), color.alpha() };
+    for (auto& span : spans) {
+        unsigned char* pixel = &bitmap.data[((static_cast<size_t>(span.y) * bitmap.width) + span.x1) * 4];
+        for (int x = span.x1; x <= span.x2; ++x, pixel += 4) memcpy(pixel, bgra, 4);
+    }
+}
+
+
 //####################################################################################
 //##    Flood Fill
 /// @brief      Fills in an area of similar colored pixels starting at (at_x, at_y) with (fill_color)
@@ -135,138 +284,58 @@ DrBitmap DrFilter::blackAndWhiteFromAlpha(const DrBitmap& bitmap, double alpha_t
 /// @ref    (flood_pixel_count):    Number of total pixels in flood
 /// @ref    (flood_rect):           Bounding box of fill area
 //####################################################################################
-#define FLOOD_NOT_PROCESSED         0
-#define FLOOD_WAS_PROCESSED         1
-#define FLOOD_MARKED_FOR_PROCESS    2
-
 DrBitmap DrFilter::floodFill(DrBitmap& bitmap, int at_x, int at_y, DrColor fill_color, double tolerance, Flood_Fill_Type type,
                              int& flood_pixel_count, DrRect& flood_rect) {
     flood_pixel_count = 0;
 
-    // Get scan lines
-    DrBitmap flood(bitmap);
-    DrBitmap processed(bitmap);
-
     // Check if start point is in range
     flood_rect = DrRect(0, 0, 0, 0);
     if (at_x < 0 || at_y < 0 || at_x > bitmap.width - 1 || at_y > bitmap.height - 1) {
         return DrBitmap();
     } else if (bitmap.width < 1 || bitmap.height < 1) {
         return DrBitmap();
-    } else if ((bitmap.width == 1) && (bitmap.height == 1)) {
-        bitmap.setPixel(0, 0, fill_color);
-        flood.setPixel(0, 0, fill_color);
-        flood_rect = DrRect(at_x, at_y, 1, 1);
-        return flood;
-    }
-
-    // Get starting color, set processed image to all zeros
-    DrColor start_color = bitmap.getPixel(at_x, at_y);
-
-    for (int x = 0; x < bitmap.width; ++x) {
-        for (int y = 0; y < bitmap.height; ++y) {
-            flood.setPixel(x, y, 0);
-            processed.setPixel(x, y, FLOOD_NOT_PROCESSED);
-        }
     }
 
-    // Push starting point onto vector
-    std::vector<DrPoint> points;
-    points.clear();
-    points.push_back(DrPoint(at_x, at_y));
-    bool processed_some;
-
-    int min_x = at_x, max_x = at_x;
-    int min_y = at_y, max_y = at_y;
-    do {
-        // Go through each point and find new points to fill
-        processed_some = false;
-        for (int p = 0; p < points.size(); ++p) {
-            DrPoint point = points[p];
-            if (processed.getPixel(point.x, point.y) == FLOOD_WAS_PROCESSED) continue;
-            bitmap.setPixel(point.x, point.y, fill_color);
-            flood.setPixel(point.x, point.y, fill_color);
-            processed.setPixel(point.x, point.y, FLOOD_WAS_PROCESSED);
-            if (point.x < min_x) min_x = point.x;
-            if (point.x > max_x) max_x = point.x;
-            if (point.y < min_y) min_y = point.y;
-            if (point.y > max_y) max_y = point.y;
-            ++flood_pixel_count;
-
-            int x_start = (point.x > 0) ?                 point.x - 1 : 0;
-            int x_end =   (point.x < bitmap.width - 1)  ? point.x + 1 : bitmap.width  - 1;
-            int y_start = (point.y > 0) ?                 point.y - 1 : 0;
-            int y_end =   (point.y < bitmap.height - 1) ? point.y + 1 : bitmap.height - 1;
-
-            for (int x = x_start; x <= x_end; ++x) {
-                for (int y = y_start; y <= y_end; ++y) {
-                    if (x == point.x && y == point.y) continue;
-
-                    if (type == DROP_FLOOD_FILL_COMPARE_4) {
-                        if ( (x == point.x - 1) && (y == point.y - 1) ) continue;
-                        if ( (x == point.x + 1) && (y == point.y - 1) ) continue;
-                        if ( (x == point.x - 1) && (y == point.y + 1) ) continue;
-                        if ( (x == point.x + 1) && (y == point.y + 1) ) continue;
-                    }
+    // Fill area of starting color
+    DrScanlineFill fill(bitmap, bitmap.getPixel(at_x, at_y), tolerance, type);
+    fill.setFillColor(fill_color);
+    flood_pixel_count = fill.run(at_x, at_y);
+    flood_rect = spanRect(fill.spans);
 
-                    if (processed.getPixel(x, y) == FLOOD_NOT_PROCESSED) {
-                        if (IsSameColor(start_color, bitmap.getPixel(x, y), tolerance)) {
-                            points.push_back(DrPoint(x, y));
-                            processed.setPixel(x, y, FLOOD_MARKED_FOR_PROCESS);
-                            processed_some = true;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Remove any points that have been processed
-        auto it = points.begin();
-        while (it != points.end()) {
-            if (processed.getPixel(it->x, it->y) == FLOOD_WAS_PROCESSED)
-                it = points.erase(it);
-            else
-                ++it;
-        }
-    } while ((points.size() > 0) && processed_some);
-
-    flood_rect = DrRect(min_x, min_y, (max_x - min_x) + 1, (max_y - min_y) + 1);
+    // Image of flood only
+    DrBitmap flood(bitmap.width, bitmap.height);
+    paintSpans(flood, fill.spans, fill_color);
     return flood;
 }
 
 
-
-
-
-
 //####################################################################################
 //##    Fill border
 //##        Traces Border of 'rect' and makes sure to fill in any DROP_COLOR_TRANSPARENT areas with fill_color
+//##        All border pixels share one fill (and one visited mask), areas already filled are skipped
 //####################################################################################
 void DrFilter::fillBorder(DrBitmap& bitmap, DrColor fill_color, DrRect rect) {
-    DrRect fill_rect;
-    int    fill_qty;
+    if (bitmap.isValid() == false) return;
+    DrScanlineFill fill(bitmap, DROP_COLOR_TRANSPARENT, 0.001, DROP_FLOOD_FILL_COMPARE_4);
+    fill.setFillColor(fill_color);
+
+    auto fill_at = [&bitmap, &fill](int x, int y) {
+        if (x < 0 || y < 0 || x > bitmap.width - 1 || y > bitmap.height - 1) return;
+        if (bitmap.getPixel(x, y) == DROP_COLOR_TRANSPARENT) fill.run(x, y);
+    };
 
     int y1 = rect.top();
     int y2 = rect.bottom();
     for (int x = rect.left(); x < rect.left() + rect.width; x++) {
-        if (bitmap.getPixel(x, y1) == DROP_COLOR_TRANSPARENT) {
-            floodFill(bitmap, x, y1, fill_color, 0.001, DROP_FLOOD_FILL_COMPARE_4, fill_qty, fill_rect);
-        }
-        if (bitmap.getPixel(x, y2) == DROP_COLOR_TRANSPARENT) {
-            floodFill(bitmap, x, y2, fill_color, 0.001, DROP_FLOOD_FILL_COMPARE_4, fill_qty, fill_rect);
-        }
+        fill_at(x, y1);
+        fill_at(x, y2);
     }
 
     int x1 = rect.left();
     int x2 = rect.right();
     for (int y = rect.top(); y < rect.top() + rect.height; y++) {
-        if (bitmap.getPixel(x1, y) == DROP_COLOR_TRANSPARENT) {
-            floodFill(bitmap, x1, y, fill_color, 0.001, DROP_FLOOD_FILL_COMPARE_4, fill_qty, fill_rect);
-        }
-        if (bitmap.getPixel(x2, y) == DROP_COLOR_TRANSPARENT) {
-            floodFill(bitmap, x2, y, fill_color, 0.001, DROP_FLOOD_FILL_COMPARE_4, fill_qty, fill_rect);
-        }
+        fill_at(x1, y);
+        fill_at(x2, y);
     }
 }
 
@@ -279,214 +348,343 @@ void DrFilter::fillBorder(DrBitmap& bitmap, DrColor fill_color, DrRect rect) {
 //##        The images are stored into the reference array passed in 'images', the images are black and white.
 //##            Black where around the ouside of of the object, and the object itself is white.
 //##        Rects of images are returned in 'rects'
+//##        Objects are returned in column major order of their first pixel (left to right, then top to bottom)
 //####################################################################################
-#define INVERTED_COLORS     true
-
 bool DrFilter::findObjectsInBitmap(const DrBitmap& bitmap, std::vector<DrBitmap>& bitmaps, std::vector<DrRect>& rects,
                         double alpha_tolerance, bool convert) {
-    DrBitmap     black_white;
-    if (convert) black_white = blackAndWhiteFromAlpha(bitmap, alpha_tolerance, INVERTED_COLORS);
-    else         black_white = bitmap;
-
-    DrColor compare(DROP_COLOR_TRANSPARENT);
-
-    // If convert is true, all object pixels will be transparent pixels. If all pixels are transparent we don't need to fill, we can
-    // just return a solid square later on and not have to run expensive flood fill routine
-    bool pixels = false;
-    if (convert == true) {
-        for (int x = 0; x < black_white.width; ++x) {
-            for (int y = 0; y < black_white.height; ++y) {
-                if (black_white.getPixel(x, y) != compare) {
-                    pixels = true;
-                    break;
-                }
+    DrObjectLabels labels;
+    labelObjects(bitmap, labels, alpha_tolerance, convert);
+
+    // If convert is true and there are no non-object pixels, return a solid image of the whole bitmap
+    size_t pixel_count = static_cast<size_t>(labels.width) * labels.height;
+    if (convert && labels.objects.size() == 1 && static_cast<size_t>(labels.objects[0].pixel_count) == pixel_count) {
+        DrBitmap solid(bitmap.width, bitmap.height);
+        for (int y = 0; y < solid.height; ++y) {
+            for (int x = 0; x < solid.width; ++x) {
+                solid.setPixel(x, y, DROP_COLOR_RED);
             }
-            if (pixels) break;
         }
+        rects.push_back( solid.rect() );
+        bitmaps.push_back( solid );
+        return false;
     }
 
-    // There are transparent pixels, we need to run flood fill routines to isolate objects
-    if (pixels || convert == false) {
-        // Loop through every pixel in image, if we find a spot that has an object,
-        // flood fill that spot and add the resulting image shape to the array of object images
-        for (int x = 0; x < black_white.width; ++x) {
-            // Process Pixel
-            for (int y = 0; y < black_white.height; ++y) {
-                if (black_white.getPixel(x, y) == compare) {
-                    DrRect      rect;
-                    int         flood_pixel_count;
-                    DrBitmap    flood_fill = floodFill(black_white, x, y, DROP_COLOR_RED, 0.001, DROP_FLOOD_FILL_COMPARE_4, flood_pixel_count, rect);
-
-                    // Add buffer around rect, create image of rect only
-                    rect.adjust(-1, -1, 1, 1);
-                    DrBitmap    fill_only = flood_fill.makeCopy(rect);
-
-                    // If adequate image, add to list of floods
-                    if (fill_only.width >= 1 && fill_only.height >= 1 && flood_pixel_count > 1) {
-                        rects.push_back( rect );
-                        bitmaps.push_back( fill_only );
-                    }
-                }
+    // Create image of each object, if adequate image, add to list of objects
+    for (auto& object : labels.objects) {
+        DrRect   rect;
+        DrBitmap image = objectBitmap(labels, object, rect);
+        if (image.width >= 1 && image.height >= 1 && object.pixel_count > 1) {
+            rects.push_back( rect );
+            bitmaps.push_back( image );
+        }
+    }
+    return false;
+}
+
+
+//####################################################################################
+//##    Label Objects
+//##        Two pass union find connected component labeling (4 connected), reads pixel bytes directly
+//##            convert == true:    Object pixels have alpha of at least 'alpha_tolerance' (0.0 to 1.0)
+//##            convert == false:   Object pixels are DROP_COLOR_TRANSPARENT (ex: holes left by fillBorder())
+//####################################################################################
+void DrFilter::labelObjects(const DrBitmap& bitmap, DrObjectLabels& labels, double alpha_tolerance, bool convert) {
+    labels.width =  bitmap.isValid() ? bitmap.width  : 0;
+    labels.height = bitmap.isValid() ? bitmap.height : 0;
+    labels.objects.clear();
+    labels.labels.assign(static_cast<size_t>(labels.width) * labels.height, 0);
+    if (bitmap.isValid() == false) return;
+
+    const int               width =         bitmap.width;
+    const int               height =        bitmap.height;
+    const int               channels =      bitmap.channels;
+    const int               alpha_byte =    (bitmap.format == DROP_BITMAP_FORMAT_GRAYSCALE) ? 0 : 3;
+    const int               alpha_i =       static_cast<int>(alpha_tolerance * 255.0);
+    const unsigned char*    pixels =        bitmap.data.data();
+    int*                    map =           labels.labels.data();
+
+    auto is_object = [=](size_t index) {
+        const unsigned char* pixel = pixels + (index * channels);
+        if (convert) return (pixel[alpha_byte] >= alpha_i);
+        for (int c = 0; c < channels; ++c) {
+            if (pixel[c] != 0) return false;
+        }
+        return true;
+    };
+
+    // Pass 1: Provisional labels from left / up neighbors, equivalent labels are joined (roots always point to smaller labels)
+    std::vector<int> parent(1, 0);
+    auto find = [&parent](int label) {
+        while (parent[label] != label) {
+            parent[label] = parent[parent[label]];
+            label = parent[label];
+        }
+        return label;
+    };
+    for (int y = 0; y < height; ++y) {
+        size_t row = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            size_t index = row + x;
+            if (is_object(index) == false) continue;
+            int left = (x > 0) ? map[index - 1]     : 0;
+            int up =   (y > 0) ? map[index - width] : 0;
+            if (left == 0 && up == 0) {
+                map[index] = static_cast<int>(parent.size());
+                parent.push_back(map[index]);
+            } else if (left != 0 && up != 0 && left != up) {
+                int root_left = find(left);
+                int root_up =   find(up);
+                if (root_left < root_up) parent[root_up] =   root_left;
+                if (root_up < root_left) parent[root_left] = root_up;
+                map[index] = (root_left < root_up) ? root_left : root_up;
+            } else {
+                map[index] = (left != 0) ? left : up;
             }
         }
+    }
 
-    // No non-object pixels, fill with DROP_COLOR_RED and return
-    } else {
-        if (black_white.width > 0 && black_white.height > 0) {
-            for (int x = 0; x < black_white.width; ++x) {
-                for (int y = 0; y < black_white.height; ++y) {
-                    black_white.setPixel(x, y, DROP_COLOR_RED);
-                }
+    // Flatten, every label points to a smaller one so one ascending sweep resolves all roots
+    for (size_t label = 1; label < parent.size(); ++label) {
+        parent[label] = parent[parent[label]];
+    }
+
+    // Pass 2: Final labels, collect bounding box / pixel count / first pixel of each object
+    std::vector<int> final_label(parent.size(), 0);
+    std::vector<DrPoint> max_point;
+    for (int y = 0; y < height; ++y) {
+        size_t row = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            size_t index = row + x;
+            if (map[index] == 0) continue;
+            int root = parent[map[index]];
+            if (final_label[root] == 0) {
+                final_label[root] = static_cast<int>(labels.objects.size()) + 1;
+                DrBitmapObject object;
+                object.label =          final_label[root];
+                object.rect =           DrRect(x, y, 1, 1);
+                object.pixel_count =    0;
+                object.first =          DrPoint(x, y);
+                labels.objects.push_back(object);
+                max_point.push_back(DrPoint(x, y));
             }
-            rects.push_back( black_white.rect() );
-            bitmaps.push_back( black_white );
+            int label = final_label[root];
+            map[index] = label;
+
+            DrBitmapObject& object = labels.objects[label - 1];
+            DrPoint& max = max_point[label - 1];
+            ++object.pixel_count;
+            if (x < object.rect.x) object.rect.x = x;
+            if (x > max.x) max.x = x;
+            if (y > max.y) max.y = y;
+            if (x < object.first.x) object.first = DrPoint(x, y);
         }
     }
+    for (size_t i = 0; i < labels.objects.size(); ++i) {
+        DrRect& rect = labels.objects[i].rect;
+        rect.width =  (max_point[i].x - rect.x) + 1;
+        rect.height = (max_point[i].y - rect.y) + 1;
+    }
 
-    return false;
+    // Order objects the way a column major scan would find them
+    std::sort(labels.objects.begin(), labels.objects.end(), [](const DrBitmapObject& a, const DrBitmapObject& b) {
+        return (a.first.x < b.first.x) || (a.first.x == b.first.x && a.first.y < b.first.y);
+    });
 }
 
 
-
 //####################################################################################
-//##    Returns a clockwise list of points representing an alpha outline of an image.
-//##    This algorithm works by moving around the image in a clockwise manner trying to stay
-//##    on the largest angle between two points. Idea and code written by Scidian Studios.
-//##        !!!!! #NOTE: Image passed in should be black and white,
-//##                     probably from DrImageing::BlackAndWhiteFromAlpha()
+//##    Returns image of one labeled object, DROP_COLOR_RED where object is, DROP_COLOR_TRANSPARENT elsewhere
+//##        'rect' is set to object bounding box plus 1 pixel buffer (kept inside image), image is size of 'rect'
 //####################################################################################
-#define TRACE_NOT_BORDER            0           // Pixels that are not near the edge
-#define TRACE_START_PIXEL           1           // Starting pixel
-#define TRACE_NOT_PROCESSED         2           // Pixels that can be part of the border
-#define TRACE_PROCESSED_ONCE        3           // Pixels that added to the border once
-#define TRACE_PROCESSED_TWICE       4           // Pixels that added to the border twice        (after a there and back again trace)
+DrBitmap DrFilter::objectBitmap(const DrObjectLabels& labels, const DrBitmapObject& object, DrRect& rect) {
+    rect = object.rect;
+    rect.adjust(-1, -1, 1, 1);
+    if (rect.x < 0) { rect.width  += rect.x;    rect.x = 0; }
+    if (rect.y < 0) { rect.height += rect.y;    rect.y = 0; }
+    if (rect.right()  > labels.width  - 1) rect.width =  labels.width  - rect.left();
+    if (rect.bottom() > labels.height - 1) rect.height = labels.height - rect.top();
+    if (rect.width <= 0 || rect.height <= 0) return DrBitmap(0, 0);
+
+    DrColor       red(DROP_COLOR_RED);
+    unsigned char bgra[4] = { red.blue(), red.green(), red.red(), red.alpha() };
+    DrBitmap      image(rect.width, rect.height);
+    for (int y = 0; y < rect.height; ++y) {
+        const int*     label = &labels.labels[(static_cast<size_t>(rect.y + y) * labels.width) + rect.x];
+        unsigned char* pixel = &image.data[static_cast<size_t>(y) * rect.width * 4];
+        for (int x = 0; x < rect.width; ++x, pixel += 4) {
+            if (label[x] == object.label) memcpy(pixel, bgra, 4);
+        }
+    }
+    return image;
+}
 
-std::vector<DrPointF> DrFilter::traceImageOutline(const DrBitmap& bitmap) {
-    // Initialize images
-    DrBitmap processed = bitmap;
-    int border_pixel_count = 0;
-
-    // Initialize point array, verify image size
-    std::vector<DrPoint> points { };
-    if (bitmap.width < 1 || bitmap.height < 1) return std::vector<DrPointF> { };
-
-    // ***** Find starting point, and also set processed image bits
-    //       !!!!! #NOTE: Important that y loop is on top, we need to come at pixel from the left
-    DrPoint last_point;
-    bool has_start_point = false;
-
-    for (int x = 0; x < bitmap.width; ++x) {
-        for (int y = 0; y < bitmap.height; ++y) {
-            // If pixel is part of the exterior, it cannot be part of the border
-            if (bitmap.getPixel(x, y) == DROP_COLOR_TRANSPARENT) {
-                processed.setPixel(x, y, TRACE_NOT_BORDER);
-                continue;
-            }
 
-            // Run through all pixels this pixel is touching to see if any are transparent (i.e. DROP_COLOR_TRANSPARENT (0))
-            bool can_be_border = false;
-            if (x == 0 || y == 0 || (x == bitmap.width - 1) || (y == bitmap.height - 1)) {
-                can_be_border = true;
-            } else {
-                for (int i = x - 1; i <= x + 1; ++i) {
-                    for (int j = y - 1; j <= y + 1; ++j) {
-                        if (bitmap.getPixel(i, j) == DROP_COLOR_TRANSPARENT) can_be_border = true;
-                    }
-                }
+//####################################################################################
+//##    Contour Tracing
+//##        Marching squares over a 1 bit mask of object pixels. Cells sit between four pixel
+//##        centers, contour points are midpoints of cell edges that split object and empty
+//##        pixels. Each step is a table lookup, no angles are measured.
+//##
+//##        - Objects are 4 connected, saddle cells keep diagonal pixels apart (same as labelObjects())
+//##        - Contours are found in a row major scan, the contour that owns the last edge crossed
+//##          on a row tells which object / hole a new contour is nested in (Suzuki - Abe)
+//####################################################################################
+// Cell edges, clockwise starting at top. Edge 'n' runs from corner 'n' to corner 'n + 1'
+#define CONTOUR_EDGE_TOP            0
+#define CONTOUR_EDGE_RIGHT          1
+#define CONTOUR_EDGE_BOTTOM         2
+#define CONTOUR_EDGE_LEFT           3
+
+// Cell corners (top left, top right, bottom right, bottom left), and cell steps across each edge
+static const int c_corner_x[4] =    { 0, 1, 1, 0 };
+static const int c_corner_y[4] =    { 0, 0, 1, 1 };
+static const int c_step_x[4] =      { 0, 1, 0, -1 };
+static const int c_step_y[4] =      { -1, 0, 1, 0 };
+
+// Object pixels of a bitmap, 1 bit each, with a border of empty pixels so cells never read outside of mask
+struct DrContourMask {
+    int                         width;                                          // Size of bitmap, mask is 2 pixels larger
+    int                         height;
+    size_t                      words;                                          // 64 bit words per mask row
+    std::vector<uint64_t>       bits;
+
+    DrContourMask(int width_, int height_) :
+        width(width_), height(height_), words((static_cast<size_t>(width_) + 2 + 63) / 64),
+        bits(words * (height_ + 2), 0) { }
+
+    // Bitmap coordinates, -1 to width / height are valid
+    bool get(int x, int y) const {
+        size_t bit = static_cast<size_t>(x + 1);
+        return (bits[(static_cast<size_t>(y + 1) * words) + (bit >> 6)] >> (bit & 63)) & 1;
+    }
+    void set(int x, int y) {
+        size_t bit = static_cast<size_t>(x + 1);
+        bits[(static_cast<size_t>(y + 1) * words) + (bit >> 6)] |= (uint64_t(1) << (bit & 63));
+    }
+};
+
+// Sets mask bit of every pixel 'is_object' returns true for, rows of mask never share words so bands can run in parallel
+template <typename Is_Object>
+static void fillContourMask(const DrBitmap& bitmap, DrContourMask& mask, Is_Object is_object) {
+    const unsigned char* pixels = bitmap.data.data();
+    const int channels = bitmap.channels;
+    ForEachRowBand(bitmap.width, bitmap.height, [&](int first_row, int end_row) {
+        for (int y = first_row; y < end_row; ++y) {
+            const unsigned char* pixel = pixels + (static_cast<size_t>(y) * bitmap.width * channels);
+            for (int x = 0; x < bitmap.width; ++x, pixel += channels) {
+                if (is_object(pixel)) mask.set(x, y);
             }
+        }
+    });
+}
 
-            // If not touching any transparent pixels, and not on edge, cannot be part of border
-            if (!can_be_border) {
-                processed.setPixel(x, y, TRACE_NOT_BORDER);
-
-            // Otherwise mark it as not processed and check if we have a start point
-            } else {
-                processed.setPixel(x, y, TRACE_NOT_PROCESSED);
-                ++border_pixel_count;
-                if (!has_start_point) {
-                    points.push_back(DrPoint(x, y));
-                    last_point = DrPoint(x - 1, y);
-                    processed.setPixel(x, y, TRACE_START_PIXEL);
-                    has_start_point = true;
-                }
-            }
+// Walks one contour starting in cell (cx, cy) entered across edge 'side', object pixels stay on the left
+//      Edges between horizontal neighbors are marked in 'owner' with 'id' so scan in traceMask() skips them
+static void walkContour(const DrContourMask& mask, std::vector<int>& owner, int id, int cx, int cy, int side, DrContour& contour) {
+    const int start_x = cx, start_y = cy, start_side = side;
+    int min_x = mask.width, min_y = mask.height, max_x = -1, max_y = -1;
+    do {
+        bool corner[4] = { mask.get(cx, cy), mask.get(cx + 1, cy), mask.get(cx + 1, cy + 1), mask.get(cx, cy + 1) };
+
+        // Exit is first edge clockwise from entry that goes from an object corner to an empty corner
+        int exit = side;
+        do { exit = (exit + 1) & 3; } while (corner[exit] == false || corner[(exit + 1) & 3] == true);
+        int next = (exit + 1) & 3;
+
+        // Object pixel on exit edge grows bounding box
+        int px = cx + c_corner_x[exit];
+        int py = cy + c_corner_y[exit];
+        if (px < min_x) min_x = px;
+        if (px > max_x) max_x = px;
+        if (py < min_y) min_y = py;
+        if (py > max_y) max_y = py;
+
+        // Add midpoint of exit edge, mark top / bottom edges (horizontal neighbors) as owned
+        contour.points.push_back(DrPointF(cx + ((c_corner_x[exit] + c_corner_x[next]) * 0.5),
+                                          cy + ((c_corner_y[exit] + c_corner_y[next]) * 0.5)));
+        if (exit == CONTOUR_EDGE_TOP || exit == CONTOUR_EDGE_BOTTOM) {
+            owner[(static_cast<size_t>(cy + c_corner_y[exit]) * (mask.width + 1)) + (cx + 1)] = id;
         }
-    }
-    if (border_pixel_count < 3) return std::vector<DrPointF> { };
 
+        // Step into neighboring cell
+        cx += c_step_x[exit];
+        cy += c_step_y[exit];
+        side = (exit + 2) & 3;
+    } while (cx != start_x || cy != start_y || side != start_side);
+    contour.rect = DrRect(min_x, min_y, (max_x - min_x) + 1, (max_y - min_y) + 1);
+}
 
-    // ***** Find outline points
-    std::vector<DrPoint> surround;
-    bool back_at_start;
-    long trace_count = 0;
-    long total_pixels = bitmap.width * bitmap.height;
-    do {
-        // Collect list of points around current point
-        surround.clear();
-        DrPoint current_point = points.back();
-        int x_start = (current_point.x > 0) ?                 current_point.x - 1 : 0;
-        int x_end =   (current_point.x < bitmap.width - 1)  ? current_point.x + 1 : bitmap.width  - 1;
-        int y_start = (current_point.y > 0) ?                 current_point.y - 1 : 0;
-        int y_end =   (current_point.y < bitmap.height - 1) ? current_point.y + 1 : bitmap.height - 1;
-        for (int x = x_start; x <= x_end; ++x) {
-            for (int y = y_start; y <= y_end; ++y) {
-                if (x == current_point.x && y == current_point.y) continue;
-                ///if ( (x == current_point.x - 1) && (y == current_point.y - 1) ) continue;
-                ///if ( (x == current_point.x + 1) && (y == current_point.y - 1) ) continue;
-                ///if ( (x == current_point.x - 1) && (y == current_point.y + 1) ) continue;
-                ///if ( (x == current_point.x + 1) && (y == current_point.y + 1) ) continue;
-                if (processed.getPixel(x, y) != TRACE_PROCESSED_TWICE && processed.getPixel(x, y) != TRACE_NOT_BORDER) {
-                    surround.push_back(DrPoint(x, y));
+// Traces every contour of mask, or only the first one found
+static std::vector<DrContour> traceMask(const DrContourMask& mask, bool first_only) {
+    std::vector<DrContour> contours;
+    std::vector<int> owner(static_cast<size_t>(mask.width + 1) * mask.height, 0);      // Contour index + 1 of edge right of pixel (x, y)
+    for (int y = 0; y < mask.height; ++y) {
+        const int* row_owner = &owner[static_cast<size_t>(y) * (mask.width + 1)];
+        int last = -1;                                                                  // Contour of last edge crossed on this row
+        for (int x = -1; x < mask.width; ++x) {
+            bool left =  mask.get(x, y);
+            bool right = mask.get(x + 1, y);
+            if (left == right) continue;
+
+            // New contour, empty -> object starts an outer contour, object -> empty starts a hole
+            if (row_owner[x + 1] == 0) {
+                DrContour contour;
+                contour.hole = left;
+                if (contour.hole) {
+                    contour.parent = (contours[last].hole) ? contours[last].parent : last;
+                } else {
+                    contour.parent = (last < 0) ? -1 : ((contours[last].hole) ? last : contours[last].parent);
+                }
+                int id = static_cast<int>(contours.size()) + 1;
+                if (contour.hole) {
+                    walkContour(mask, owner, id, x, y - 1, CONTOUR_EDGE_BOTTOM, contour);
+                } else {
+                    walkContour(mask, owner, id, x, y,     CONTOUR_EDGE_TOP,    contour);
                 }
+                contours.push_back(contour);
+                if (first_only) return contours;
             }
+            last = row_owner[x + 1] - 1;
         }
+    }
+    return contours;
+}
 
-        // Compare surrounding points to see which one has the greatest angle measured clockwise from the last set of points
-        double   last_point_angle = CalcRotationAngleInDegrees(current_point.toPointF(), last_point.toPointF());
-        double   angle_diff = 0;
-        bool     first = true;
-        DrPoint  next_point;
-        for (auto point : surround) {
-            // Find angle of point
-            double check_angle = CalcRotationAngleInDegrees(current_point.toPointF(), point.toPointF());
-            while (check_angle > 0) {                 check_angle -= 360.0; }
-            while (check_angle <= last_point_angle) { check_angle += 360.0; }
-
-            // Add penalty for each time pixel has been checked
-            ///if (processed_lines[point.y][point.x] != TRACE_START_PIXEL)
-            ///    check_angle += (processed_lines[point.y][point.x] - TRACE_NOT_PROCESSED) * 360.0;
-
-            // See if next closest point
-            double check_point_diff = check_angle - last_point_angle;
-            if (first || check_point_diff < angle_diff) {
-                angle_diff = check_point_diff;
-                next_point = point;
-                first = false;
-            }
-        }
 
-        // If we found an angle, we found our next point, add it to the list
-        if (surround.size() > 0) {
-            if (processed.getPixel(current_point.x, current_point.y) == TRACE_NOT_PROCESSED)
-                processed.setPixel(current_point.x, current_point.y, TRACE_PROCESSED_ONCE);
-            else if (processed.getPixel(current_point.x, current_point.y) == TRACE_PROCESSED_ONCE)
-                processed.setPixel(current_point.x, current_point.y, TRACE_PROCESSED_TWICE);
-            last_point = current_point;
-            points.push_back(next_point);
-        }
+//####################################################################################
+//##    Returns outlines of all objects in an image, and of the holes in those objects
+//##        Object pixels have alpha of at least 'alpha_tolerance' (0.0 to 1.0)
+//####################################################################################
+std::vector<DrContour> DrFilter::traceContours(const DrBitmap& bitmap, double alpha_tolerance) {
+    if (bitmap.isValid() == false) return std::vector<DrContour> { };
+    const int alpha_byte = (bitmap.format == DROP_BITMAP_FORMAT_GRAYSCALE) ? 0 : 3;
+    const int alpha_i =    static_cast<int>(alpha_tolerance * 255.0);
+
+    DrContourMask mask(bitmap.width, bitmap.height);
+    fillContourMask(bitmap, mask, [=](const unsigned char* pixel) { return pixel[alpha_byte] >= alpha_i; });
+    return traceMask(mask, false);
+}
 
-        // Check if we're back at start and no more options
-        back_at_start = (processed.getPixel(points.back().x, points.back().y) == TRACE_START_PIXEL);
-        ++trace_count;
 
-    } while ((surround.size() > 0) && !back_at_start);
+//####################################################################################
+//##    Returns outline of first object found in an image (pixels that are not DROP_COLOR_TRANSPARENT)
+//##        Points are a closed loop, first point is not repeated at the end
+//##        !!!!! #NOTE: Image passed in should be black and white,
+//##                     probably from DrImageing::BlackAndWhiteFromAlpha()
+//####################################################################################
+std::vector<DrPointF> DrFilter::traceImageOutline(const DrBitmap& bitmap) {
+    if (bitmap.isValid() == false) return std::vector<DrPointF> { };
+    const int channels = bitmap.channels;
 
-    // ***** Convert to DrPointF array and return
-    std::vector<DrPointF> hull_points;
-    for (size_t i = 0; i < points.size(); ++i) {
-        hull_points.push_back(DrPointF(points[i].x, points[i].y));
-    }
-    return hull_points;
+    DrContourMask mask(bitmap.width, bitmap.height);
+    fillContourMask(bitmap, mask, [=](const unsigned char* pixel) {
+        for (int c = 0; c < channels; ++c) {
+            if (pixel[c] != 0) return true;
+        }
+        return false;
+    });
+    std::vector<DrContour> contours = traceMask(mask, true);
+    return (contours.empty()) ? std::vector<DrPointF> { } : contours[0].points;
 }
 
 
@@ -10,7 +10,9 @@
 #ifndef IMAGE_FILTER_H
 #define IMAGE_FILTER_H
 
+#include "../geometry/Point.h"
 #include "../geometry/PointF.h"
+#include "../geometry/Rect.h"
 #include "Bitmap.h"
 
 
@@ -33,6 +35,37 @@ enum Flood_Fill_Type {
 };
 
 
+//####################################################################################
+//##    Object Labels
+//##        Connected objects of a bitmap, filled by DrFilter::labelObjects()
+//############################
+struct DrBitmapObject {
+    int                 label;                      // Value of object pixels in label map
+    DrRect              rect;                       // Bounding box of object pixels
+    int                 pixel_count;                // Number of object pixels
+    DrPoint             first;                      // First object pixel in column major order
+};
+
+struct DrObjectLabels {
+    int                             width =     0;
+    int                             height =    0;
+    std::vector<int>                labels;         // One per pixel (row major), 0 is background
+    std::vector<DrBitmapObject>     objects;        // Sorted by 'first' pixel (left to right, then top to bottom)
+};
+
+
+//####################################################################################
+//##    Contours
+//##        Outlines of bitmap objects and their holes, filled by DrFilter::traceContours()
+//############################
+struct DrContour {
+    std::vector<DrPointF>           points;         // Closed loop through pixel edge midpoints, first point is not repeated
+    DrRect                          rect;           // Bounding box of object pixels along contour
+    bool                            hole;           // False for outside of an object, true for a hole in an object
+    int                             parent;         // Index of contour this one is inside of (holes -> object, objects -> hole), or -1
+};
+
+
 //####################################################################################
 //##    DrFilter
 //##        STATIC CLASS: Image editing / object finding
@@ -53,10 +86,13 @@ public:
     static void        fillBorder(DrBitmap& bitmap, DrColor fill_color, DrRect rect);
     static bool        findObjectsInBitmap(const DrBitmap& bitmap, std::vector<DrBitmap>& bitmaps, std::vector<DrRect>& rects,
                                            double alpha_tolerance, bool convert = true);
+    static void        labelObjects(const DrBitmap& bitmap, DrObjectLabels& labels, double alpha_tolerance, bool convert = true);
+    static DrBitmap    objectBitmap(const DrObjectLabels& labels, const DrBitmapObject& object, DrRect& rect);
     static DrBitmap    floodFill(DrBitmap& bitmap, int at_x, int at_y, DrColor fill_color, double tolerance, Flood_Fill_Type type,
                                  int& flood_pixel_count, DrRect& flood_rect);
 
     // ***** Outlining
+    static std::vector<DrContour>   traceContours(const DrBitmap& bitmap, double alpha_tolerance);
     static std::vector<DrPointF>    traceImageOutline(const DrBitmap &bitmap);
 
 };
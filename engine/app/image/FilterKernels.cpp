@@ -0,0 +1,297 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include "../core/Math.h"
+#include "FilterKernels.h"
+#if defined(DROP_FILTER_SSE2)
+    #include <immintrin.h>
+#endif
+
+#if defined(DROP_FILTER_AVX2)
+    #define AVX2_FUNCTION   __attribute__((target("avx2")))
+#endif
+
+// Local Constants
+#define GRAY_WEIGHT_RED         6966                                            // 0.2126 * 32768
+#define GRAY_WEIGHT_GREEN       23436                                           // 0.7152 * 32768
+#define GRAY_WEIGHT_BLUE        2366                                            // 0.0722 * 32768
+#define GRAY_WEIGHT_SHIFT       15
+
+
+//####################################################################################
+//##    Local Functions
+//####################################################################################
+// Channel offset added by brightness / opacity, saturated to 0 to 255 range
+static unsigned char filterAmount(int value) {
+    return static_cast<unsigned char>(Clamp(value < 0 ? -value : value, 0, 255));
+}
+
+// Brightness / contrast lookup table, same math as DrFilter::applySinglePixelFilter()
+static void filterTable(Image_Filter_Type filter, int value, unsigned char table[256]) {
+    for (int i = 0; i < 256; ++i) {
+        switch (filter) {
+            case DROP_IMAGE_FILTER_BRIGHTNESS:  table[i] = static_cast<unsigned char>(Clamp(i + value, 0, 255));                                  break;
+            case DROP_IMAGE_FILTER_CONTRAST:    table[i] = static_cast<unsigned char>(Clamp(((i - 127) * (value + 128) / 128) + 127, 0, 255));    break;
+            default:                            table[i] = static_cast<unsigned char>(i);
+        }
+    }
+}
+
+
+//####################################################################################
+//##    Scalar Kernels
+//####################################################################################
+// Contrast has no byte wise SIMD equivalent, vector kernels leave it to the lookup table here
+static void filterScalar(Image_Filter_Type filter, unsigned char* p, size_t pixel_count, int value) {
+    unsigned char table[256];
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:
+        case DROP_IMAGE_FILTER_CONTRAST:
+            filterTable(filter, value, table);
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                p[0] = table[p[0]];
+                p[1] = table[p[1]];
+                p[2] = table[p[2]];
+            }
+            break;
+        case DROP_IMAGE_FILTER_GRAYSCALE:
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                unsigned gray = ((p[0] * GRAY_WEIGHT_BLUE) + (p[1] * GRAY_WEIGHT_GREEN) + (p[2] * GRAY_WEIGHT_RED)) >> GRAY_WEIGHT_SHIFT;
+                p[0] = p[1] = p[2] = static_cast<unsigned char>(gray);
+            }
+            break;
+        case DROP_IMAGE_FILTER_NEGATIVE:
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                p[0] = 255 - p[0];
+                p[1] = 255 - p[1];
+                p[2] = 255 - p[2];
+            }
+            break;
+        case DROP_IMAGE_FILTER_OPACITY:
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                p[3] = static_cast<unsigned char>(Clamp(p[3] + value, 0, 255));
+            }
+            break;
+        case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA:
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                unsigned alpha = p[3];
+                p[0] = static_cast<unsigned char>((p[0] * alpha) / 255);
+                p[1] = static_cast<unsigned char>((p[1] * alpha) / 255);
+                p[2] = static_cast<unsigned char>((p[2] * alpha) / 255);
+            }
+            break;
+        default: ;
+    }
+}
+
+
+//####################################################################################
+//##    SSE2 Kernels
+//##        4 pixels per register, leftover pixels are handled by scalar kernels
+//####################################################################################
+#if defined(DROP_FILTER_SSE2)
+
+// Gray value of 4 pixels (as 32 bit lanes), pixels unpacked to 16 bit channels
+static inline __m128i grayPairSse2(__m128i channels, __m128i weights) {
+    __m128i sums = _mm_madd_epi16(channels, weights);                           // (b*wb + g*wg), (r*wr + a*0) per pixel
+    sums = _mm_add_epi32(sums, _mm_srli_epi64(sums, 32));
+    return _mm_srli_epi32(sums, GRAY_WEIGHT_SHIFT);                             // Gray in lanes 0 and 2
+}
+
+static size_t filterSse2(Image_Filter_Type filter, unsigned char* bgra, size_t pixel_count, int value) {
+    size_t count = pixel_count & ~static_cast<size_t>(3);
+    const __m128i zero =        _mm_setzero_si128();
+    const __m128i alpha_mask =  _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i color_mask =  _mm_set1_epi32(0x00FFFFFF);
+    const __m128i amount =      _mm_set1_epi8(static_cast<char>(filterAmount(value)));
+
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:
+        case DROP_IMAGE_FILTER_OPACITY: {
+            __m128i add = _mm_and_si128(amount, (filter == DROP_IMAGE_FILTER_OPACITY) ? alpha_mask : color_mask);
+            for (size_t i = 0; i < count; i += 4) {
+                __m128i* at = reinterpret_cast<__m128i*>(bgra + (i * 4));
+                __m128i p = _mm_loadu_si128(at);
+                p = (value < 0) ? _mm_subs_epu8(p, add) : _mm_adds_epu8(p, add);
+                _mm_storeu_si128(at, p);
+            }
+            break;
+        }
+        case DROP_IMAGE_FILTER_GRAYSCALE: {
+            const __m128i weights = _mm_setr_epi16(GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0,
+                                                   GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0);
+            for (size_t i = 0; i < count; i += 4) {
+                __m128i* at = reinterpret_cast<__m128i*>(bgra + (i * 4));
+                __m128i p =  _mm_loadu_si128(at);
+                __m128i lo = _mm_shuffle_epi32(grayPairSse2(_mm_unpacklo_epi8(p, zero), weights), _MM_SHUFFLE(3, 3, 2, 0));
+                __m128i hi = _mm_shuffle_epi32(grayPairSse2(_mm_unpackhi_epi8(p, zero), weights), _MM_SHUFFLE(3, 3, 2, 0));
+                __m128i gray = _mm_unpacklo_epi64(lo, hi);
+                gray = _mm_or_si128(gray, _mm_or_si128(_mm_slli_epi32(gray, 8), _mm_slli_epi32(gray, 16)));
+                _mm_storeu_si128(at, _mm_or_si128(gray, _mm_and_si128(p, alpha_mask)));
+            }
+            break;
+        }
+        case DROP_IMAGE_FILTER_NEGATIVE:
+            for (size_t i = 0; i < count; i += 4) {
+                __m128i* at = reinterpret_cast<__m128i*>(bgra + (i * 4));
+                _mm_storeu_si128(at, _mm_xor_si128(_mm_loadu_si128(at), color_mask));
+            }
+            break;
+        case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA: {
+            const __m128i one = _mm_set1_epi16(1);
+            for (size_t i = 0; i < count; i += 4) {
+                __m128i* at = reinterpret_cast<__m128i*>(bgra + (i * 4));
+                __m128i p = _mm_loadu_si128(at);
+                __m128i halves[2] = { _mm_unpacklo_epi8(p, zero), _mm_unpackhi_epi8(p, zero) };
+                for (int h = 0; h < 2; ++h) {
+                    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                    __m128i x = _mm_mullo_epi16(halves[h], alpha);
+                    halves[h] = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);    // floor(x / 255)
+                }
+                __m128i result = _mm_packus_epi16(halves[0], halves[1]);
+                _mm_storeu_si128(at, _mm_or_si128(_mm_and_si128(result, color_mask), _mm_and_si128(p, alpha_mask)));
+            }
+            break;
+        }
+        default:
+            return 0;
+    }
+    return count;
+}
+
+#endif  // DROP_FILTER_SSE2
+
+
+//####################################################################################
+//##    AVX2 Kernels
+//##        8 pixels per register, same math as SSE2 kernels (unpack / pack / shuffle work within each 128 bit lane)
+//####################################################################################
+#if defined(DROP_FILTER_AVX2)
+
+AVX2_FUNCTION static inline __m256i grayPairAvx2(__m256i channels, __m256i weights) {
+    __m256i sums = _mm256_madd_epi16(channels, weights);
+    sums = _mm256_add_epi32(sums, _mm256_srli_epi64(sums, 32));
+    return _mm256_srli_epi32(sums, GRAY_WEIGHT_SHIFT);
+}
+
+AVX2_FUNCTION static size_t filterAvx2(Image_Filter_Type filter, unsigned char* bgra, size_t pixel_count, int value) {
+    size_t count = pixel_count & ~static_cast<size_t>(7);
+    const __m256i zero =        _mm256_setzero_si256();
+    const __m256i alpha_mask =  _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    const __m256i color_mask =  _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i amount =      _mm256_set1_epi8(static_cast<char>(filterAmount(value)));
+
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:
+        case DROP_IMAGE_FILTER_OPACITY: {
+            __m256i add = _mm256_and_si256(amount, (filter == DROP_IMAGE_FILTER_OPACITY) ? alpha_mask : color_mask);
+            for (size_t i = 0; i < count; i += 8) {
+                __m256i* at = reinterpret_cast<__m256i*>(bgra + (i * 4));
+                __m256i p = _mm256_loadu_si256(at);
+                p = (value < 0) ? _mm256_subs_epu8(p, add) : _mm256_adds_epu8(p, add);
+                _mm256_storeu_si256(at, p);
+            }
+            break;
+        }
+        case DROP_IMAGE_FILTER_GRAYSCALE: {
+            const __m256i weights = _mm256_setr_epi16(GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0,
+                                                      GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0,
+                                                      GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0,
+                                                      GRAY_WEIGHT_BLUE, GRAY_WEIGHT_GREEN, GRAY_WEIGHT_RED, 0);
+            for (size_t i = 0; i < count; i += 8) {
+                __m256i* at = reinterpret_cast<__m256i*>(bgra + (i * 4));
+                __m256i p =  _mm256_loadu_si256(at);
+                __m256i lo = _mm256_shuffle_epi32(grayPairAvx2(_mm256_unpacklo_epi8(p, zero), weights), _MM_SHUFFLE(3, 3, 2, 0));
+                __m256i hi = _mm256_shuffle_epi32(grayPairAvx2(_mm256_unpackhi_epi8(p, zero), weights), _MM_SHUFFLE(3, 3, 2, 0));
+                __m256i gray = _mm256_unpacklo_epi64(lo, hi);
+                gray = _mm256_or_si256(gray, _mm256_or_si256(_mm256_slli_epi32(gray, 8), _mm256_slli_epi32(gray, 16)));
+                _mm256_storeu_si256(at, _mm256_or_si256(gray, _mm256_and_si256(p, alpha_mask)));
+            }
+            break;
+        }
+        case DROP_IMAGE_FILTER_NEGATIVE:
+            for (size_t i = 0; i < count; i += 8) {
+                __m256i* at = reinterpret_cast<__m256i*>(bgra + (i * 4));
+                _mm256_storeu_si256(at, _mm256_xor_si256(_mm256_loadu_si256(at), color_mask));
+            }
+            break;
+        case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA: {
+            const __m256i one = _mm256_set1_epi16(1);
+            for (size_t i = 0; i < count; i += 8) {
+                __m256i* at = reinterpret_cast<__m256i*>(bgra + (i * 4));
+                __m256i p = _mm256_loadu_si256(at);
+                __m256i halves[2] = { _mm256_unpacklo_epi8(p, zero), _mm256_unpackhi_epi8(p, zero) };
+                for (int h = 0; h < 2; ++h) {
+                    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(halves[h], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                    __m256i x = _mm256_mullo_epi16(halves[h], alpha);
+                    halves[h] = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+                }
+                __m256i result = _mm256_packus_epi16(halves[0], halves[1]);
+                _mm256_storeu_si256(at, _mm256_or_si256(_mm256_and_si256(result, color_mask), _mm256_and_si256(p, alpha_mask)));
+            }
+            break;
+        }
+        default:
+            return 0;
+    }
+    return count;
+}
+
+#endif  // DROP_FILTER_AVX2
+
+
+//####################################################################################
+//##    Dispatch
+//####################################################################################
+bool HasFilterKernel(Image_Filter_Type filter) {
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:
+        case DROP_IMAGE_FILTER_CONTRAST:
+        case DROP_IMAGE_FILTER_GRAYSCALE:
+        case DROP_IMAGE_FILTER_NEGATIVE:
+        case DROP_IMAGE_FILTER_OPACITY:
+        case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Filter_Isa BestFilterIsa() {
+    static const Filter_Isa best = []() {
+        #if defined(DROP_FILTER_AVX2)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return DROP_FILTER_ISA_AVX2;
+        #endif
+        #if defined(DROP_FILTER_SSE2)
+            return DROP_FILTER_ISA_SSE2;
+        #else
+            return DROP_FILTER_ISA_SCALAR;
+        #endif
+    }();
+    return best;
+}
+
+bool FilterPixels(Image_Filter_Type filter, unsigned char* bgra, size_t pixel_count, int value, Filter_Isa isa) {
+    if (HasFilterKernel(filter) == false) return false;
+    if (isa > BestFilterIsa()) isa = BestFilterIsa();
+
+    // Vector kernels return number of pixels processed, scalar kernel finishes the rest
+    size_t done = 0;
+    #if defined(DROP_FILTER_AVX2)
+        if (isa == DROP_FILTER_ISA_AVX2) done = filterAvx2(filter, bgra, pixel_count, value);
+    #endif
+    #if defined(DROP_FILTER_SSE2)
+        if (isa == DROP_FILTER_ISA_SSE2 || (isa == DROP_FILTER_ISA_AVX2 && pixel_count - done >= 4)) {
+            done += filterSse2(filter, bgra + (done * 4), pixel_count - done, value);
+        }
+    #endif
+    filterScalar(filter, bgra + (done * 4), pixel_count - done, value);
+    return true;
+}
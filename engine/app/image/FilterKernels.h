@@ -0,0 +1,54 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef IMAGE_FILTER_KERNELS_H
+#define IMAGE_FILTER_KERNELS_H
+
+// Includes
+#include <cstddef>
+#include "Filter.h"
+
+// Instruction sets available to filter kernels
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define DROP_FILTER_SSE2
+#endif
+#if defined(DROP_FILTER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+    #define DROP_FILTER_AVX2                                                    // Compiled with target attribute, used when cpu supports it
+#endif
+
+// Filter kernel instruction sets
+enum Filter_Isa {
+    DROP_FILTER_ISA_SCALAR,
+    DROP_FILTER_ISA_SSE2,
+    DROP_FILTER_ISA_AVX2,
+    DROP_FILTER_ISA_BEST,                                                       // Fastest instruction set supported by cpu
+};
+
+
+//####################################################################################
+//##    Filter Kernels
+//##        Per pixel filters that run directly on 8-bit BGRA pixel data (DrBitmap::data of DROP_BITMAP_FORMAT_ARGB)
+//##
+//##        - Kernels use integer math, every instruction set produces identical output
+//##        - Brightness, contrast and opacity match applySinglePixelFilter() table math exactly
+//##        - Negative is (255 - c), premultiply is floor(c * a / 255), grayscale uses 15 bit fixed point weights (0.2126, 0.7152, 0.0722)
+//##        - DROP_IMAGE_FILTER_HUE and DROP_IMAGE_FILTER_SATURATION have no kernel
+//############################
+// Returns true if 'filter' has a kernel
+bool        HasFilterKernel(Image_Filter_Type filter);
+
+// Returns fastest instruction set supported by cpu (checked once)
+Filter_Isa  BestFilterIsa();
+
+// Applies 'filter' to 'pixel_count' BGRA pixels in place, returns false (and leaves pixels untouched) if filter has no kernel.
+// Requesting an instruction set not supported by the build / cpu falls back to the next best one
+bool        FilterPixels(Image_Filter_Type filter, unsigned char* bgra, size_t pixel_count, int value, Filter_Isa isa = DROP_FILTER_ISA_BEST);
+
+
+#endif // IMAGE_FILTER_KERNELS_H
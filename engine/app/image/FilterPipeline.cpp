@@ -0,0 +1,155 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include "../core/Math.h"
+#include "Color.h"
+#include "FilterKernels.h"
+#include "FilterPipeline.h"
+#include "RowBands.h"
+
+
+//####################################################################################
+//##    Local Functions
+//####################################################################################
+// Returns true if filter can be expressed as a per channel lookup table
+static bool isTableFilter(Image_Filter_Type filter) {
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:
+        case DROP_IMAGE_FILTER_CONTRAST:
+        case DROP_IMAGE_FILTER_NEGATIVE:
+        case DROP_IMAGE_FILTER_OPACITY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Runs channel 'c' (BGRA order) through filter, same math as FilterKernels.cpp
+static int tableFilter(Image_Filter_Type filter, int value, int channel, int c) {
+    bool alpha = (channel == 3);
+    switch (filter) {
+        case DROP_IMAGE_FILTER_BRIGHTNESS:  return alpha ? c : Clamp(c + value, 0, 255);
+        case DROP_IMAGE_FILTER_CONTRAST:    return alpha ? c : Clamp(((c - 127) * (value + 128) / 128) + 127, 0, 255);
+        case DROP_IMAGE_FILTER_NEGATIVE:    return alpha ? c : 255 - c;
+        case DROP_IMAGE_FILTER_OPACITY:     return alpha ? Clamp(c + value, 0, 255) : c;
+        default:                            return c;
+    }
+}
+
+
+//####################################################################################
+//##    Building
+//####################################################################################
+// Adds filter to end of pipeline, lookup table filters are folded into the previous stage when possible
+DrFilterPipeline& DrFilterPipeline::add(Image_Filter_Type filter, int value) {
+    m_steps.push_back(DrFilterStep { filter, value });
+
+    // Saturation is not implemented by applySinglePixelFilter() either
+    if (filter == DROP_IMAGE_FILTER_SATURATION) return *this;
+
+    if (isTableFilter(filter) == false) {
+        m_stages.push_back(DrFilterStage { filter, value, -1 });
+        return *this;
+    }
+
+    // Start a new identity table unless last stage is already a table
+    if (m_stages.empty() || m_stages.back().table < 0) {
+        int table = static_cast<int>(m_tables.size() / (4 * 256));
+        m_tables.resize(m_tables.size() + (4 * 256));
+        unsigned char* entries = &m_tables[table * 4 * 256];
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int i = 0; i < 256; ++i) entries[(channel * 256) + i] = static_cast<unsigned char>(i);
+        }
+        m_stages.push_back(DrFilterStage { filter, value, table });
+    }
+
+    // Compose filter onto table
+    unsigned char* entries = &m_tables[m_stages.back().table * 4 * 256];
+    for (int channel = 0; channel < 4; ++channel) {
+        for (int i = 0; i < 256; ++i) {
+            unsigned char& entry = entries[(channel * 256) + i];
+            entry = static_cast<unsigned char>(tableFilter(filter, value, channel, entry));
+        }
+    }
+    return *this;
+}
+
+void DrFilterPipeline::clear() {
+    m_steps.clear();
+    m_stages.clear();
+    m_tables.clear();
+}
+
+
+//####################################################################################
+//##    Applying
+//####################################################################################
+// Filters bitmap in place, split into row bands across image thread pool
+//      Grayscale bitmaps fall back to DrFilter::applySinglePixelFilter() one filter at a time
+void DrFilterPipeline::apply(DrBitmap& bitmap) const {
+    if (bitmap.isValid() == false) return;
+    if (bitmap.format == DROP_BITMAP_FORMAT_ARGB && bitmap.channels == 4) {
+        unsigned char* pixels = bitmap.data.data();
+        size_t row_pixels = static_cast<size_t>(bitmap.width);
+        ForEachRowBand(bitmap.width, bitmap.height, [this, pixels, row_pixels](int first_row, int end_row) {
+            apply(pixels + (first_row * row_pixels * 4), (end_row - first_row) * row_pixels);
+        });
+    } else {
+        for (auto& step : m_steps) {
+            DrBitmap filtered = DrFilter::applySinglePixelFilter(step.filter, bitmap, step.value);
+            bitmap.swap(filtered);
+        }
+    }
+}
+
+// Filters BGRA pixel data in place, every stage is run on one block of pixels before moving to the next block
+void DrFilterPipeline::apply(unsigned char* bgra, size_t pixel_count) const {
+    if (m_stages.empty()) return;
+    for (size_t start = 0; start < pixel_count; start += FILTER_PIPELINE_BLOCK) {
+        size_t count = (pixel_count - start < FILTER_PIPELINE_BLOCK) ? (pixel_count - start) : FILTER_PIPELINE_BLOCK;
+        applyBlock(bgra + (start * 4), count);
+    }
+}
+
+void DrFilterPipeline::applyBlock(unsigned char* bgra, size_t pixel_count) const {
+    for (auto& stage : m_stages) {
+        // Folded lookup table
+        if (stage.table >= 0) {
+            const unsigned char* blue =  &m_tables[stage.table * 4 * 256];
+            const unsigned char* green = blue  + 256;
+            const unsigned char* red =   green + 256;
+            const unsigned char* alpha = red   + 256;
+            unsigned char* p = bgra;
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                p[0] = blue[p[0]];
+                p[1] = green[p[1]];
+                p[2] = red[p[2]];
+                p[3] = alpha[p[3]];
+            }
+
+        // Hsv, same math as DrFilter::applySinglePixelFilter()
+        } else if (stage.filter == DROP_IMAGE_FILTER_HUE) {
+            unsigned char* p = bgra;
+            for (size_t i = 0; i < pixel_count; ++i, p += 4) {
+                DrColor color(p[2], p[1], p[0], p[3]);
+                DrHsv hsv = color.getHsv();
+                hsv.hue = Clamp(hsv.hue + stage.value, -360.0, 360.0);
+                color.setFromHsv(hsv);
+                p[0] = color.blue();
+                p[1] = color.green();
+                p[2] = color.red();
+                p[3] = color.alpha();
+            }
+
+        // Vectorized kernel
+        } else {
+            FilterPixels(stage.filter, bgra, pixel_count, stage.value);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef IMAGE_FILTER_PIPELINE_H
+#define IMAGE_FILTER_PIPELINE_H
+
+// Includes
+#include <cstddef>
+#include <vector>
+#include "Filter.h"
+
+// Local Defines
+#define FILTER_PIPELINE_BLOCK       1024                                        // Pixels run through all stages at a time (stays in L1 cache)
+
+
+//####################################################################################
+//##    DrFilterPipeline
+//##        Chain of per pixel filters applied in place, in one pass over the pixels
+//##
+//##        Usage:
+//##            DrFilterPipeline pipeline;
+//##            pipeline.add(DROP_IMAGE_FILTER_BRIGHTNESS, 20).add(DROP_IMAGE_FILTER_CONTRAST, 40).add(DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA);
+//##            pipeline.apply(bitmap);
+//##
+//##        - Neighboring brightness, contrast, negative and opacity filters are folded into one lookup table per channel
+//##        - Grayscale / premultiply run vectorized kernels (see FilterKernels.h), hue goes through DrHsv
+//##        - Results match applying the same filters one at a time with DrFilter::applySinglePixelFilter()
+//############################
+class DrFilterPipeline
+{
+private:
+    // Local Structs
+    struct DrFilterStep {
+        Image_Filter_Type       filter;
+        int                     value;
+    };
+    struct DrFilterStage {
+        Image_Filter_Type       filter;                                         // Filter of stage, unused for lookup table stages
+        int                     value;
+        int                     table;                                          // Index of lookup table in 'm_tables', or -1
+    };
+
+    // #################### VARIABLES ####################
+    std::vector<DrFilterStep>   m_steps             { };                        // Filters in order added
+    std::vector<DrFilterStage>  m_stages            { };                        // Filters after folding lookup table steps
+    std::vector<unsigned char>  m_tables            { };                        // Lookup tables, 4 * 256 bytes each (BGRA order)
+
+public:
+    // #################### FUNCTIONS ####################
+    // Building
+    DrFilterPipeline&   add(Image_Filter_Type filter, int value = 0);
+    void                clear();
+    size_t              filterCount() const     { return m_steps.size(); }
+    size_t              stageCount() const      { return m_stages.size(); }             // Passes needed per block after folding
+    bool                empty() const           { return m_stages.empty(); }
+
+    // Applying
+    void                apply(DrBitmap& bitmap) const;                                  // Filters bitmap in place
+    void                apply(unsigned char* bgra, size_t pixel_count) const;           // Filters BGRA pixel data in place
+
+private:
+    void                applyBlock(unsigned char* bgra, size_t pixel_count) const;
+};
+
+
+#endif // IMAGE_FILTER_PIPELINE_H
@@ -73,39 +73,34 @@ void DrImage::outlinePoints(float lod) {
     m_poly_list.clear();
     m_hole_list.clear();
 
-    // ***** Break pixmap into seperate images for each object in image
-    std::vector<DrBitmap>   bitmaps;
-    std::vector<DrRect>     rects;
-    bool    cancel = DrFilter::findObjectsInBitmap(m_bitmap, bitmaps, rects, c_alpha_tolerance, true);
-    int     number_of_objects = static_cast<int>(bitmaps.size());
+    // ***** Trace outlines of every object in image along with their holes
+    std::vector<DrContour> contours = DrFilter::traceContours(m_bitmap, c_alpha_tolerance);
 
-    //std::cout << "Number of objects in image: " << number_of_objects << std::endl;
+    // Single pixel objects / holes are skipped (their contour is a 4 point diamond), unless object is the whole image
+    size_t min_points = (m_bitmap.width * m_bitmap.height > 1) ? 5 : 4;
 
-    // ***** If Find Objects In Bitmap never finished, just add simple box shape
-    if (cancel) { setSimpleBox(); return; }
+    // ***** Group holes with the object they are inside of
+    std::vector<std::vector<int>> object_holes(contours.size());
+    for (int i = 0; i < static_cast<int>(contours.size()); i++) {
+        if (contours[i].hole && contours[i].parent >= 0) object_holes[contours[i].parent].push_back(i);
+    }
 
-    // ******************** Go through each image (object) and Polygon for it
-    for (int image_number = 0; image_number < number_of_objects; image_number++) {
-        // Grab next image, check if its valid
-        DrBitmap &image = bitmaps[image_number];
-        if (image.width < 1 || image.height < 1) continue;
+    //std::cout << "Number of contours in image: " << contours.size() << std::endl;
 
-        // Trace edge of image
-        std::vector<DrPointF> one_poly = DrFilter::traceImageOutline(image);
+    // ******************** Go through each object and Polygon for it
+    for (int object_number = 0; object_number < static_cast<int>(contours.size()); object_number++) {
+        const DrContour &object = contours[object_number];
+        if (object.hole || object.points.size() < min_points) continue;
+        std::vector<DrPointF> one_poly = object.points;
 
-        // Add rect offset, and add 1.00 pixels buffer around image
+        // Add 1.00 pixels buffer around image
         double plus_one_pixel_percent_x = 1.0 + (1.00 / m_bitmap.width);
         double plus_one_pixel_percent_y = 1.0 + (1.00 / m_bitmap.height);
         for (auto &point : one_poly) {
-            point.x += rects[image_number].left();
-            point.y += rects[image_number].top();
             point.x = point.x * plus_one_pixel_percent_x;
             point.y = point.y * plus_one_pixel_percent_y;
         }
 
-        // Remove duplicate first point
-        if (one_poly.size() > 3) one_poly.pop_back();
-
         // Optimize point list
         if (one_poly.size() > (c_neighbors * 2)) {
             one_poly = DrMesh::smoothPoints(one_poly, c_neighbors, 20.0, 1.0);
@@ -113,14 +108,18 @@ void DrImage::outlinePoints(float lod) {
             //one_poly = DrMesh::insertPoints(one_poly);
         }
 
-        // If we only have a couple points left, add shape as a box of the original image, otherwise use PolylineSimplification points
+        // If we only have a couple points left, add shape as a box of the original object, otherwise use PolylineSimplification points
         if (one_poly.size() < 4) {
             ///points = HullFinder::FindConcaveHull(points, 5.0);
+            double left =   object.rect.x;
+            double top =    object.rect.y;
+            double right =  object.rect.x + object.rect.width;
+            double bottom = object.rect.y + object.rect.height;
             one_poly.clear();
-            one_poly.push_back( DrPointF(rects[image_number].topLeft().x,        rects[image_number].topLeft().y) );
-            one_poly.push_back( DrPointF(rects[image_number].topRight().x,       rects[image_number].topRight().y) );
-            one_poly.push_back( DrPointF(rects[image_number].bottomRight().x,    rects[image_number].bottomRight().y) );
-            one_poly.push_back( DrPointF(rects[image_number].bottomLeft().x,     rects[image_number].bottomLeft().y) );
+            one_poly.push_back( DrPointF(left,  top) );
+            one_poly.push_back( DrPointF(right, top) );
+            one_poly.push_back( DrPointF(right, bottom) );
+            one_poly.push_back( DrPointF(left,  bottom) );
         }
 
         // Check winding
@@ -130,32 +129,11 @@ void DrImage::outlinePoints(float lod) {
         m_poly_list.push_back(one_poly);
 
 
-        // ******************** Copy image and finds holes as seperate outlines
-        DrBitmap holes = image.makeCopy();
-        DrFilter::fillBorder(holes, DROP_COLOR_WHITE, holes.rect());                      // Ensures only holes are left as black spots
-
-        // Breaks holes into seperate images for each Hole
-        std::vector<DrBitmap> hole_images;
-        std::vector<DrRect>   hole_rects;
-        DrFilter::findObjectsInBitmap(holes, hole_images, hole_rects, c_alpha_tolerance, false);
-
-        // Go through each image (Hole) create list for it
+        // ******************** Go through each Hole of object and create list for it
         std::vector<std::vector<DrPointF>> hole_list;
-        for (int hole_number = 0; hole_number < static_cast<int>(hole_images.size()); hole_number++) {
-            DrBitmap &hole = hole_images[hole_number];
-            if (hole.width < 1 || hole.height < 1) continue;
-
-            // Trace edge of hole
-            std::vector<DrPointF> one_hole = DrFilter::traceImageOutline(hole);
-
-            // Add in sub image offset to points and hole rects
-            for (auto &point : one_hole) {
-                point.x += rects[image_number].left() + hole_rects[hole_number].left();
-                point.y += rects[image_number].top()  + hole_rects[hole_number].top();
-            }
-
-            // Remove duplicate first point
-            if (one_hole.size() > 3) one_hole.pop_back();
+        for (auto hole_number : object_holes[object_number]) {
+            if (contours[hole_number].points.size() < min_points) continue;
+            std::vector<DrPointF> one_hole = contours[hole_number].points;
 
             // Optimize point list
             if (one_hole.size() > (c_neighbors * 2)) {
@@ -171,7 +149,7 @@ void DrImage::outlinePoints(float lod) {
         }
         m_hole_list.push_back(hole_list);
 
-    }   // End for each bitmap
+    }   // End for each object
 
 
     // ***** Mark this DrImage as having traced the image outline
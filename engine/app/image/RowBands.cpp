@@ -0,0 +1,45 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <atomic>
+#include "../core/ThreadPool.h"
+#include "RowBands.h"
+
+// Thread pool shared by bitmap operations
+static std::atomic<DrThreadPool*>   l_image_pool { nullptr };
+
+
+//####################################################################################
+//##    Thread Pool
+//####################################################################################
+void SetImageThreadPool(DrThreadPool* pool) {
+    l_image_pool.store(pool);
+}
+
+DrThreadPool* ImageThreadPool() {
+    return l_image_pool.load();
+}
+
+
+//####################################################################################
+//##    Bands
+//####################################################################################
+// Calls 'func(first_row, end_row)' for every band of rows in [0, height), returns once all bands are finished
+void ForEachRowBand(int width, int height, std::function<void(int first_row, int end_row)> func) {
+    if (width < 1 || height < 1) return;
+    int rows_per_band = ROW_BAND_PIXELS / width;
+    if (rows_per_band < 1) rows_per_band = 1;
+
+    DrThreadPool* pool = ImageThreadPool();
+    if (pool == nullptr || pool->threadCount() == 0 || rows_per_band >= height) {
+        func(0, height);
+        return;
+    }
+    pool->parallelFor(height, rows_per_band, func);
+}
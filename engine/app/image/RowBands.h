@@ -0,0 +1,39 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef IMAGE_ROW_BANDS_H
+#define IMAGE_ROW_BANDS_H
+
+// Includes
+#include <functional>
+
+// Forward Declarations
+class DrThreadPool;
+
+// Local Defines
+#define ROW_BAND_PIXELS     (64 * 1024)                                         // Target pixels per band, smaller images run on calling thread
+
+
+//####################################################################################
+//##    Row Bands
+//##        Splits images into bands of whole rows and runs them across the image thread pool
+//##
+//##        - Band size only depends on image size, each row is handled by exactly one band, so output is
+//##          identical to running single threaded as long as 'func' only writes the rows it is given
+//##        - Without a thread pool (or with a pool that has no workers) bands run on the calling thread
+//############################
+// Sets thread pool used by bitmap operations, nullptr runs everything on the calling thread
+void            SetImageThreadPool(DrThreadPool* pool);
+DrThreadPool*   ImageThreadPool();
+
+// Calls 'func(first_row, end_row)' for every band of rows in [0, height), returns once all bands are finished
+void            ForEachRowBand(int width, int height, std::function<void(int first_row, int end_row)> func);
+
+
+#endif // IMAGE_ROW_BANDS_H
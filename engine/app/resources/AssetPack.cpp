@@ -0,0 +1,338 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "engine/app/image/Bitmap.h"
+#include "engine/data/Constants.h"
+#include "engine/data/Serialize.h"
+#include "engine/scene3d/Mesh.h"
+#include "AssetPack.h"
+
+// Memory mapping is available on posix platforms, others read the whole file
+#if defined(DROP_TARGET_LINUX) || defined(DROP_TARGET_APPLE) || defined(DROP_TARGET_GOOGLE)
+    #define ASSET_PACK_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+//####################################################################################
+//##    Local Structs
+//####################################################################################
+struct DrAssetPackHeader {
+    char                magic[4];
+    std::uint32_t       drop_version;                                           // DROP_VERSION of app that wrote file
+    std::uint32_t       format_version;                                         // ASSET_PACK_FORMAT of app that wrote file
+    std::uint32_t       entry_count;
+    std::uint64_t       index_offset;
+    std::uint64_t       names_offset;
+    std::uint64_t       names_size;
+};
+
+// Mesh blob header, followed by Vertex array and index array
+struct DrAssetPackMesh {
+    std::uint32_t       vertex_count;
+    std::uint32_t       index_count;
+};
+
+
+//####################################################################################
+//##    Local Functions
+//####################################################################################
+// 64 bit FNV-1a
+static std::uint64_t HashAssetName(const char* name, size_t length) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Rounds 'offset' up to next multiple of ASSET_PACK_ALIGN
+static std::uint64_t AlignPackOffset(std::uint64_t offset) {
+    return (offset + (ASSET_PACK_ALIGN - 1)) & ~static_cast<std::uint64_t>(ASSET_PACK_ALIGN - 1);
+}
+
+// Returns true if range ['offset', 'offset' + 'length') is within 'size', without overflowing
+static bool RangeInside(std::uint64_t offset, std::uint64_t length, std::uint64_t size) {
+    return (offset <= size && length <= size - offset);
+}
+
+
+//####################################################################################
+//##    DrAssetPack - Open / Close
+//####################################################################################
+// Maps pack file, returns false if file is missing or invalid
+bool DrAssetPack::open(const std::string& file_path) {
+    close();
+
+    #if defined(ASSET_PACK_MMAP)
+        int file = ::open(file_path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat file_stat;
+        if (fstat(file, &file_stat) != 0 || file_stat.st_size <= 0) { ::close(file); return false; }
+        void* mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);                                                          // Mapping stays valid after file is closed
+        if (mapping == MAP_FAILED) return false;
+        m_data = static_cast<const char*>(mapping);
+        m_size = static_cast<size_t>(file_stat.st_size);
+        m_mapped = true;
+    #else
+        FILE* file = fopen(file_path.c_str(), "rb");
+        if (file == nullptr) return false;
+        fseek(file, 0, SEEK_END);
+        long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (file_size <= 0) { fclose(file); return false; }
+        m_buffer.resize(static_cast<size_t>(file_size));
+        size_t read = fread(m_buffer.data(), 1, m_buffer.size(), file);
+        fclose(file);
+        if (read != m_buffer.size()) { m_buffer.clear(); return false; }
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    #endif
+
+    if (validate() == false) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DrAssetPack::close() {
+    #if defined(ASSET_PACK_MMAP)
+        if (m_mapped) munmap(const_cast<char*>(m_data), m_size);
+    #endif
+    std::vector<char>().swap(m_buffer);
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_entries = nullptr;
+    m_entry_count = 0;
+    m_names = nullptr;
+}
+
+// Checks header / index / names fit inside file, sets index pointers
+bool DrAssetPack::validate() {
+    if (m_size < sizeof(DrAssetPackHeader)) return false;
+    DrAssetPackHeader header;
+    memcpy(&header, m_data, sizeof(DrAssetPackHeader));
+    if (memcmp(header.magic, ASSET_PACK_MAGIC, 4) != 0) return false;
+    if (header.format_version != ASSET_PACK_FORMAT) return false;
+
+    // Index and name table
+    if (header.index_offset % alignof(DrAssetPackEntry) != 0) return false;
+    if (header.entry_count > m_size / sizeof(DrAssetPackEntry)) return false;
+    if (RangeInside(header.index_offset, std::uint64_t(header.entry_count) * sizeof(DrAssetPackEntry), m_size) == false) return false;
+    if (RangeInside(header.names_offset, header.names_size, m_size) == false) return false;
+    const DrAssetPackEntry* entries = reinterpret_cast<const DrAssetPackEntry*>(m_data + header.index_offset);
+
+    // Entries
+    for (std::uint32_t i = 0; i < header.entry_count; ++i) {
+        const DrAssetPackEntry& entry = entries[i];
+        if (RangeInside(entry.name_offset, entry.name_length, header.names_size) == false) return false;
+        if (RangeInside(entry.offset, entry.size, m_size) == false) return false;
+        if (i > 0 && entries[i - 1].name_hash > entry.name_hash) return false;
+    }
+
+    m_entries = entries;
+    m_entry_count = header.entry_count;
+    m_names = m_data + header.names_offset;
+    return true;
+}
+
+
+//####################################################################################
+//##    DrAssetPack - Index
+//####################################################################################
+// Returns nullptr if pack has no asset 'name'
+const DrAssetPackEntry* DrAssetPack::find(const std::string& name) const {
+    std::uint64_t hash = HashAssetName(name.data(), name.size());
+    const DrAssetPackEntry* end = m_entries + m_entry_count;
+    const DrAssetPackEntry* it = std::lower_bound(m_entries, end, hash,
+        [](const DrAssetPackEntry& entry, std::uint64_t value) { return entry.name_hash < value; });
+
+    // Compare names, in case of hash collision
+    for (; it != end && it->name_hash == hash; ++it) {
+        if (it->name_length == name.size() && memcmp(m_names + it->name_offset, name.data(), name.size()) == 0) return it;
+    }
+    return nullptr;
+}
+
+std::string DrAssetPack::name(const DrAssetPackEntry& entry) const {
+    return std::string(m_names + entry.name_offset, entry.name_length);
+}
+
+
+//####################################################################################
+//##    DrAssetPack - Asset Data
+//####################################################################################
+// Copies pre-decoded pixels into 'bitmap', no image decoding takes place
+bool DrAssetPack::loadBitmap(const std::string& name, DrBitmap& bitmap) const {
+    const DrAssetPackEntry* entry = find(name);
+    if (entry == nullptr || entry->type != ASSET_PACK_BITMAP) return false;
+    if (entry->channels != DROP_BITMAP_FORMAT_ARGB) return false;
+    if (std::uint64_t(entry->width) * entry->height * entry->channels != entry->size || entry->size == 0) return false;
+    bitmap = DrBitmap(reinterpret_cast<const unsigned char*>(data(*entry)), static_cast<int>(entry->size), false,
+                      static_cast<int>(entry->width), static_cast<int>(entry->height));
+    return true;
+}
+
+bool DrAssetPack::loadMesh(const std::string& name, DrMesh& mesh) const {
+    const DrAssetPackEntry* entry = find(name);
+    if (entry == nullptr || entry->type != ASSET_PACK_MESH) return false;
+    if (entry->size < sizeof(DrAssetPackMesh)) return false;
+    DrAssetPackMesh header;
+    memcpy(&header, data(*entry), sizeof(DrAssetPackMesh));
+    std::uint64_t vertex_bytes = std::uint64_t(header.vertex_count) * sizeof(Vertex);
+    std::uint64_t index_bytes =  std::uint64_t(header.index_count)  * sizeof(unsigned int);
+    if (sizeof(DrAssetPackMesh) + vertex_bytes + index_bytes != entry->size) return false;
+
+    const char* vertices = data(*entry) + sizeof(DrAssetPackMesh);
+    mesh.vertices.resize(header.vertex_count);
+    mesh.indices.resize(header.index_count);
+    if (vertex_bytes > 0) memcpy(mesh.vertices.data(), vertices, vertex_bytes);
+    if (index_bytes > 0)  memcpy(mesh.indices.data(), vertices + vertex_bytes, index_bytes);
+    return true;
+}
+
+// Deserializes scene directly out of the mapping
+bool DrAssetPack::loadScene(const std::string& name, DrCoordinator* ecs) const {
+    const DrAssetPackEntry* entry = find(name);
+    if (entry == nullptr || entry->type != ASSET_PACK_SCENE) return false;
+    return DeserializeScene(ecs, data(*entry), static_cast<size_t>(entry->size));
+}
+
+
+//####################################################################################
+//##    DrAssetPackWriter - Adding Assets
+//####################################################################################
+DrAssetPackWriter::DrPackAsset& DrAssetPackWriter::addAsset(const std::string& name, Asset_Pack_Type type) {
+    DrPackAsset* asset = nullptr;
+    for (auto& existing : m_assets) {
+        if (existing.name == name) { asset = &existing; break; }
+    }
+    if (asset == nullptr) {
+        m_assets.push_back(DrPackAsset());
+        asset = &m_assets.back();
+        asset->name = name;
+    }
+    asset->type = type;
+    asset->width = 0;
+    asset->height = 0;
+    asset->channels = 0;
+    asset->data.clear();
+    return *asset;
+}
+
+void DrAssetPackWriter::addBlob(const std::string& name, const void* data, size_t size) {
+    DrPackAsset& asset = addAsset(name, ASSET_PACK_RAW);
+    const char* bytes = static_cast<const char*>(data);
+    asset.data.assign(bytes, bytes + size);
+}
+
+// Stores pixels as they are in 'bitmap', should be called before premultiplying alpha
+void DrAssetPackWriter::addBitmap(const std::string& name, const DrBitmap& bitmap) {
+    DrPackAsset& asset = addAsset(name, ASSET_PACK_BITMAP);
+    asset.width =    static_cast<std::uint32_t>(bitmap.width);
+    asset.height =   static_cast<std::uint32_t>(bitmap.height);
+    asset.channels = static_cast<std::uint32_t>(bitmap.channels);
+    const char* pixels = reinterpret_cast<const char*>(bitmap.data.data());
+    asset.data.assign(pixels, pixels + bitmap.data.size());
+}
+
+void DrAssetPackWriter::addMesh(const std::string& name, const DrMesh& mesh) {
+    DrPackAsset& asset = addAsset(name, ASSET_PACK_MESH);
+    DrAssetPackMesh header;
+    header.vertex_count = static_cast<std::uint32_t>(mesh.vertices.size());
+    header.index_count =  static_cast<std::uint32_t>(mesh.indices.size());
+    size_t vertex_bytes = mesh.vertices.size() * sizeof(Vertex);
+    size_t index_bytes =  mesh.indices.size()  * sizeof(unsigned int);
+    asset.data.resize(sizeof(DrAssetPackMesh) + vertex_bytes + index_bytes);
+    memcpy(&asset.data[0], &header, sizeof(DrAssetPackMesh));
+    if (vertex_bytes > 0) memcpy(&asset.data[sizeof(DrAssetPackMesh)], mesh.vertices.data(), vertex_bytes);
+    if (index_bytes > 0)  memcpy(&asset.data[sizeof(DrAssetPackMesh) + vertex_bytes], mesh.indices.data(), index_bytes);
+}
+
+// Returns false if scene could not be serialized
+bool DrAssetPackWriter::addScene(const std::string& name, DrCoordinator* ecs) {
+    std::vector<char> scene;
+    if (SerializeScene(ecs, scene) == false) return false;
+    DrPackAsset& asset = addAsset(name, ASSET_PACK_SCENE);
+    asset.data.swap(scene);
+    return true;
+}
+
+
+//####################################################################################
+//##    DrAssetPackWriter - Output
+//####################################################################################
+// Returns false if file could not be written
+bool DrAssetPackWriter::write(const std::string& file_path) const {
+    // Sort index by name hash
+    std::vector<DrAssetPackEntry> entries(m_assets.size());
+    std::vector<char> names;
+    std::uint64_t offset = AlignPackOffset(sizeof(DrAssetPackHeader));
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        const DrPackAsset& asset = m_assets[i];
+        DrAssetPackEntry& entry = entries[i];
+        entry.name_hash =   HashAssetName(asset.name.data(), asset.name.size());
+        entry.name_offset = static_cast<std::uint32_t>(names.size());
+        entry.name_length = static_cast<std::uint32_t>(asset.name.size());
+        entry.type =        asset.type;
+        entry.width =       asset.width;
+        entry.height =      asset.height;
+        entry.channels =    asset.channels;
+        entry.offset =      offset;
+        entry.size =        asset.data.size();
+        names.insert(names.end(), asset.name.begin(), asset.name.end());
+        offset = AlignPackOffset(offset + asset.data.size());
+    }
+    std::vector<size_t> order(m_assets.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&entries](size_t a, size_t b) { return entries[a].name_hash < entries[b].name_hash; });
+
+    DrAssetPackHeader header;
+    memset(&header, 0, sizeof(DrAssetPackHeader));
+    memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+    header.drop_version =   DROP_VERSION;
+    header.format_version = ASSET_PACK_FORMAT;
+    header.entry_count =    static_cast<std::uint32_t>(entries.size());
+    header.index_offset =   offset;
+    header.names_offset =   offset + entries.size() * sizeof(DrAssetPackEntry);
+    header.names_size =     names.size();
+
+    // Write header, blobs, index, names
+    FILE* file = fopen(file_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    const char padding[ASSET_PACK_ALIGN] = { };
+    bool ok = (fwrite(&header, sizeof(DrAssetPackHeader), 1, file) == 1);
+    std::uint64_t at = sizeof(DrAssetPackHeader);
+    for (size_t i = 0; i < m_assets.size() && ok; ++i) {
+        std::uint64_t pad = entries[i].offset - at;
+        if (pad > 0) ok = ok && (fwrite(padding, 1, pad, file) == pad);
+        if (m_assets[i].data.size() > 0) ok = ok && (fwrite(m_assets[i].data.data(), 1, m_assets[i].data.size(), file) == m_assets[i].data.size());
+        at = entries[i].offset + entries[i].size;
+    }
+    if (ok && header.index_offset > at) {
+        std::uint64_t pad = header.index_offset - at;
+        ok = (fwrite(padding, 1, pad, file) == pad);
+    }
+    for (size_t i = 0; i < order.size() && ok; ++i) {
+        ok = (fwrite(&entries[order[i]], sizeof(DrAssetPackEntry), 1, file) == 1);
+    }
+    if (ok && names.size() > 0) ok = (fwrite(names.data(), 1, names.size(), file) == names.size());
+    fclose(file);
+    return ok;
+}
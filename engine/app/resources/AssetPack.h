@@ -0,0 +1,150 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_APP_ASSET_PACK_H
+#define DR_APP_ASSET_PACK_H
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward Declarations
+class DrBitmap;
+class DrCoordinator;
+class DrMesh;
+
+// Local Defines
+#define ASSET_PACK_MAGIC        "DRPK"                                          // First 4 bytes of an asset pack file
+#define ASSET_PACK_FORMAT            1                                          // Version of asset pack layout, bump when layout below changes
+#define ASSET_PACK_ALIGN            64                                          // Blobs and index start on this byte alignment (from start of file)
+
+// Enums
+enum Asset_Pack_Type {
+    ASSET_PACK_RAW =        0,                                                  // Arbitrary bytes
+    ASSET_PACK_BITMAP =     1,                                                  // Decoded, non-premultiplied pixels (width * height * channels bytes)
+    ASSET_PACK_MESH =       2,                                                  // Vertex count, index count, Vertex array, index array
+    ASSET_PACK_SCENE =      3,                                                  // Binary scene, see Serialize.h
+};
+
+
+//####################################################################################
+//##    Asset Pack Index Entry
+//##        Stored as-is in file, index is sorted by 'name_hash'
+//############################
+struct DrAssetPackEntry {
+    std::uint64_t       name_hash;                                              // 64 bit FNV-1a hash of asset name
+    std::uint32_t       name_offset;                                            // Offset of asset name in name table
+    std::uint32_t       name_length;                                            // Byte length of asset name
+    std::uint32_t       type;                                                   // Asset_Pack_Type
+    std::uint32_t       width;                                                  // Bitmap width
+    std::uint32_t       height;                                                 // Bitmap height
+    std::uint32_t       channels;                                               // Bitmap channels
+    std::uint64_t       offset;                                                 // Offset of blob from start of file
+    std::uint64_t       size;                                                   // Byte size of blob
+};
+
+
+//####################################################################################
+//##    DrAssetPack
+//##        Read only pack of pre-decoded assets, opened with mmap where available (whole file is read otherwise)
+//##
+//##        Layout (native byte order):
+//##            Header:     magic, DROP_VERSION, ASSET_PACK_FORMAT, entry count, index offset, name table offset / size
+//##            Blobs:      Asset data, each aligned to ASSET_PACK_ALIGN
+//##            Index:      Array of DrAssetPackEntry sorted by name hash (lookup is a binary search)
+//##            Names:      Asset names, not null terminated
+//##
+//##        - data() returns pointers into the mapping, they are valid until the pack is closed
+//##        - loadBitmap() / loadMesh() copy the blob out of the mapping (one memcpy, no decoding), the
+//##          returned object owns its data and outlives the pack
+//##        - Nothing is decoded on load, opening a pack only touches the header, index and names
+//############################
+class DrAssetPack
+{
+public:
+    // Constructor / Destructor
+    DrAssetPack() { }
+    ~DrAssetPack() { close(); }
+    DrAssetPack(const DrAssetPack&) = delete;
+    DrAssetPack& operator=(const DrAssetPack&) = delete;
+
+private:
+    // #################### VARIABLES ####################
+    const char*                 m_data              { nullptr };                    // Start of file in memory
+    size_t                      m_size              { 0 };                          // Byte size of file
+    bool                        m_mapped            { false };                      // True when 'm_data' is a memory mapping
+    std::vector<char>           m_buffer            { };                            // File contents when memory mapping is not available
+
+    const DrAssetPackEntry*     m_entries           { nullptr };                    // Index, points into file
+    std::uint32_t               m_entry_count       { 0 };                          // Number of assets in pack
+    const char*                 m_names             { nullptr };                    // Name table, points into file
+
+public:
+    // #################### FUNCTIONS ####################
+    // Open / Close
+    bool                        open(const std::string& file_path);                 // Maps pack file, returns false if file is missing or invalid
+    void                        close();
+    bool                        isOpen() const      { return (m_data != nullptr); }
+
+    // Index
+    std::uint32_t               entryCount() const              { return m_entry_count; }
+    const DrAssetPackEntry&     entry(std::uint32_t index) const { return m_entries[index]; }
+    const DrAssetPackEntry*     find(const std::string& name) const;                // Returns nullptr if pack has no asset 'name'
+    std::string                 name(const DrAssetPackEntry& entry) const;
+
+    // Asset Data
+    const char*                 data(const DrAssetPackEntry& entry) const   { return m_data + entry.offset; }
+    bool                        loadBitmap(const std::string& name, DrBitmap& bitmap) const;
+    bool                        loadMesh(const std::string& name, DrMesh& mesh) const;
+    bool                        loadScene(const std::string& name, DrCoordinator* ecs) const;
+
+private:
+    bool                        validate();                                         // Checks header / index / names fit inside file, sets index pointers
+};
+
+
+//####################################################################################
+//##    DrAssetPackWriter
+//##        Collects assets in memory and writes them as an asset pack, adding a name twice replaces the earlier asset
+//############################
+class DrAssetPackWriter
+{
+private:
+    // Local Structs
+    struct DrPackAsset {
+        std::string             name;
+        std::uint32_t           type;
+        std::uint32_t           width;
+        std::uint32_t           height;
+        std::uint32_t           channels;
+        std::vector<char>       data;
+    };
+
+    // #################### VARIABLES ####################
+    std::vector<DrPackAsset>    m_assets            { };                            // Assets to write, in order added
+
+public:
+    // #################### FUNCTIONS ####################
+    // Adding Assets
+    void        addBlob(const std::string& name, const void* data, size_t size);
+    void        addBitmap(const std::string& name, const DrBitmap& bitmap);
+    void        addMesh(const std::string& name, const DrMesh& mesh);
+    bool        addScene(const std::string& name, DrCoordinator* ecs);             // Returns false if scene could not be serialized
+
+    // Output
+    size_t      assetCount() const      { return m_assets.size(); }
+    bool        write(const std::string& file_path) const;                          // Returns false if file could not be written
+
+private:
+    DrPackAsset&    addAsset(const std::string& name, Asset_Pack_Type type);
+};
+
+
+#endif  // DR_APP_ASSET_PACK_H
@@ -0,0 +1,120 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <cstring>
+#include "engine/app/core/Math.h"
+#include "engine/app/geometry/Point.h"
+#include "engine/app/geometry/Rect.h"
+#include "AtlasPacker.h"
+
+
+//####################################################################################
+//##    Constructor
+//####################################################################################
+DrAtlasPacker::DrAtlasPacker(int atlas_size) {
+    reset(atlas_size);
+}
+
+// Empties Atlas at new size, new blank shadow copy
+void DrAtlasPacker::reset(int atlas_size) {
+    m_size = atlas_size;
+    m_pixels_used = 0;
+    m_nodes.resize(static_cast<size_t>(atlas_size));
+    stbrp_init_target(&m_context, atlas_size, atlas_size, &m_nodes[0], static_cast<int>(m_nodes.size()));
+    DrBitmap shadow(atlas_size, atlas_size, DROP_BITMAP_FORMAT_ARGB);
+    m_shadow.swap(shadow);
+}
+
+
+//####################################################################################
+//##    Packing
+//####################################################################################
+// Packs image into space left on Atlas, if it doesn't fit Atlas is grown (up to 'max_size') and everything is repacked
+Atlas_Pack_Result DrAtlasPacker::add(int key, const DrBitmap& bitmap, int padding, int max_size) {
+    DrAtlasSlot slot { key, &bitmap, padding, stbrp_rect() };
+        slot.rect.id = key;
+        slot.rect.w =  bitmap.width  + (padding*2);
+        slot.rect.h =  bitmap.height + (padding*2);
+
+    // Test if new image fits in space that is left
+    bool packed = false;
+    if ((slot.rect.w * slot.rect.h) <= availablePixels()) {
+        packed = (stbrp_pack_rects(&m_context, &slot.rect, 1) == 1);
+    }
+    if (packed == false) {
+        m_slots.push_back(slot);
+        if (grow(bitmap, max_size)) return ATLAS_PACK_GREW;
+        m_slots.pop_back();
+        return ATLAS_PACK_FAILED;
+    }
+
+    // Copy it onto shadow copy
+    m_slots.push_back(slot);
+    m_pixels_used += slot.rect.w * slot.rect.h;
+    CopyIntoAtlas(bitmap, m_shadow, slot.rect.x + padding, slot.rect.y + padding);
+    return ATLAS_PACK_ADDED;
+}
+
+// Increases Atlas size until every slot (new image is last) fits, then repacks and copies all of them
+//      Returns false if needed size is past 'max_size', Atlas is left unchanged
+bool DrAtlasPacker::grow(const DrBitmap& bitmap, int max_size) {
+    // Find size that will fit existing atlas plus new image
+    int atlas_x2 =  m_size * 2;
+    int min_dimen = m_size + bitmap.minDimension();
+    int max_dimen = bitmap.maxDimension();
+    int size_needed = 0;
+    if ((min_dimen <= atlas_x2) && (max_dimen <= atlas_x2)) {
+        size_needed = Max(min_dimen, max_dimen);
+    } else {
+        size_needed = m_size + bitmap.maxDimension();
+    }
+
+    // Try increasing sizes until everything fits
+    std::vector<stbrp_rect> rects(m_slots.size());
+    for (size_t i = 0; i < m_slots.size(); ++i) rects[i] = m_slots[i].rect;
+    for (int atlas_size = RoundPowerOf2(size_needed); atlas_size <= max_size; atlas_size *= 2) {
+        std::vector<stbrp_node> nodes(static_cast<size_t>(atlas_size));
+        stbrp_context context;
+        stbrp_init_target(&context, atlas_size, atlas_size, &nodes[0], static_cast<int>(nodes.size()));
+        if (stbrp_pack_rects(&context, &rects[0], static_cast<int>(rects.size())) == 0) continue;
+
+        // Rebuild atlas at new size (same rects in same order pack the same way), packer keeps going from here for future images
+        reset(atlas_size);
+        stbrp_pack_rects(&m_context, &rects[0], static_cast<int>(rects.size()));
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            DrAtlasSlot& slot = m_slots[i];
+            slot.rect = rects[i];
+            m_pixels_used += slot.rect.w * slot.rect.h;
+            CopyIntoAtlas(*slot.bitmap, m_shadow, slot.rect.x + slot.padding, slot.rect.y + slot.padding);
+        }
+        return true;
+    }
+    return false;
+}
+
+
+//####################################################################################
+//##    Copying
+//####################################################################################
+void CopyIntoAtlas(const DrBitmap& source, DrBitmap& dest, int x, int y) {
+    if (source.channels != 4 || dest.channels != 4) {
+        DrRect  source_rect = source.rect();
+        DrPoint dest_point(x, y);
+        DrBitmap::Blit(source, source_rect, dest, dest_point);
+        return;
+    }
+    int width =  Min(source.width,  dest.width  - x);
+    int height = Min(source.height, dest.height - y);
+    if (x < 0 || y < 0 || width <= 0 || height <= 0) return;
+    for (int row = 0; row < height; ++row) {
+        const unsigned char* from = &source.data[static_cast<size_t>(row) * source.width * 4];
+        unsigned char*       to =   &dest.data[((static_cast<size_t>(y + row) * dest.width) + x) * 4];
+        memcpy(to, from, static_cast<size_t>(width) * 4);
+    }
+}
@@ -0,0 +1,76 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_APP_ATLAS_PACKER_H
+#define DR_APP_ATLAS_PACKER_H
+
+// Include
+#include <vector>
+#include "3rd_party/stb/stb_rect_pack.h"
+#include "engine/app/image/Bitmap.h"
+
+// Enums
+enum Atlas_Pack_Result {
+    ATLAS_PACK_FAILED,                                                              // Image does not fit, even at largest allowed size, nothing changed
+    ATLAS_PACK_ADDED,                                                               // Image was packed into space that was left, other images did not move
+    ATLAS_PACK_GREW,                                                                // Atlas grew, every image was repacked and copied onto new shadow copy
+};
+
+// Image packed onto a DrAtlasPacker
+struct DrAtlasSlot {
+    int                 key;                                                        // Image key
+    const DrBitmap*     bitmap;                                                     // Image pixels, must stay valid while image is on Atlas
+    int                 padding;                                                    // Border around image inside 'rect'
+    stbrp_rect          rect;                                                       // Packed position, includes padding
+};
+
+
+//####################################################################################
+//##    DrAtlasPacker
+//##        Cpu side of a multi image Atlas, no gpu calls (DrImageManager uploads the shadow copy). Skyline packer
+//##        (stb_rect_pack) kept for the life of the Atlas, new images are packed into the space that is left and
+//##        copied onto the shadow copy one row at a time. Images already on the Atlas only move when it grows
+//############################
+class DrAtlasPacker
+{
+public:
+    // Constructor / Destructor
+    DrAtlasPacker(int atlas_size);
+    DrAtlasPacker(const DrAtlasPacker&) = delete;                                   // 'm_context' points into itself / 'm_nodes'
+    DrAtlasPacker& operator=(const DrAtlasPacker&) = delete;
+
+private:
+    // #################### VARIABLES ####################
+    int                         m_size              { 0 };                          // Width and height of Atlas
+    int                         m_pixels_used       { 0 };                          // Pixels of packed rects (padding included)
+    stbrp_context               m_context;                                          // Skyline packer state
+    std::vector<stbrp_node>     m_nodes             { };                            // Storage used by 'm_context'
+    std::vector<DrAtlasSlot>    m_slots             { };                            // Images on Atlas, in order added
+    DrBitmap                    m_shadow;                                           // Cpu copy of Atlas pixels
+
+public:
+    // #################### FUNCTIONS ####################
+    Atlas_Pack_Result           add(int key, const DrBitmap& bitmap, int padding, int max_size);
+
+    // Getters
+    int                             size() const                { return m_size; }
+    int                             pixelsUsed() const          { return m_pixels_used; }
+    int                             availablePixels() const     { return (m_size * m_size) - m_pixels_used; }
+    const std::vector<DrAtlasSlot>& slots() const               { return m_slots; }
+    const DrBitmap&                 shadow() const              { return m_shadow; }
+
+private:
+    bool                        grow(const DrBitmap& bitmap, int max_size);
+    void                        reset(int atlas_size);
+};
+
+// Copies 'source' into 'dest' with its top left corner at (x, y), ARGB bitmaps are copied one row at a time
+void CopyIntoAtlas(const DrBitmap& source, DrBitmap& dest, int x, int y);
+
+#endif // DR_APP_ATLAS_PACKER_H
@@ -7,14 +7,19 @@
 // @source      https://github.com/scidian/eyedrop
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
+#include <cstring>
 #include "3rd_party/stb/stb_rect_pack.h"
 #include "engine/app/core/Math.h"
+#include "engine/app/core/ThreadPool.h"
 #include "engine/app/geometry/Point.h"
 #include "engine/app/geometry/Rect.h"
 #include "engine/app/image/Image.h"
 #include "engine/app/image/Bitmap.h"
 #include "engine/app/image/Filter.h"
+#include "engine/app/image/FilterPipeline.h"
 #include "engine/app/App.h"
+#include "AssetPack.h"
+#include "AtlasPacker.h"
 #include "ImageManager.h"
 
 
@@ -75,43 +80,102 @@ void DrImageManager::fetchImage(ImageLoadData image_data) {
     m_load_image_stack.push_back(image_data);
 }
 
+// Adds images to stack of images to be loaded in the background, as one batch
+//      Batch is finished together once every image in it has been created, each Atlas it touches is uploaded once
+void DrImageManager::fetchImages(std::vector<ImageLoadData> batch) {
+    int batch_key = m_next_batch++;
+    for (auto& image_data : batch) {
+        image_data.batch = batch_key;
+        m_load_image_stack.push_back(image_data);
+    }
+}
+
 // Loads image immediately
 void DrImageManager::loadImage(ImageLoadData image_data) {
-    // Load from file, check image dimensions aren't too large! Max width and height are MAX_IMAGE_SIZE!
-    DrBitmap bmp(image_data.image_file);
+    loadImages({ image_data });
+}
+
+// Loads images immediately, files are decoded in parallel on the thread pool, then packed as one batch
+//      Multi image Atlases they land on are uploaded by the next processUploads()
+void DrImageManager::loadImages(std::vector<ImageLoadData> batch) {
+    std::vector<std::shared_ptr<ImageJob>> jobs;
+    for (auto& image_data : batch) {
+        jobs.push_back(std::make_shared<ImageJob>(image_data));
+    }
+
+    auto work = [&jobs](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            // Load from file, check image dimensions aren't too large! Max width and height are MAX_IMAGE_SIZE!
+            DrBitmap bmp(jobs[i]->load_data.image_file);
+            if (bmp.width > MAX_IMAGE_SIZE || bmp.height > MAX_IMAGE_SIZE) continue;
+
+            // Attempt to create image
+            jobs[i]->image = createImage(jobs[i]->load_data, bmp);
+        }
+    };
+    DrThreadPool* pool = App()->threadPool();
+    if (pool == nullptr) {
+        work(0, static_cast<int>(jobs.size()));
+    } else {
+        pool->parallelFor(static_cast<int>(jobs.size()), 1, work);
+    }
+    finishImages(jobs);
+}
+
+// Loads image immediately from pre-decoded pixels in an asset pack, 'image_file' is the asset name
+void DrImageManager::loadImageFromPack(const DrAssetPack& pack, ImageLoadData image_data) {
+    DrBitmap bmp;
+    if (pack.loadBitmap(image_data.image_file, bmp) == false) return;
     if (bmp.width > MAX_IMAGE_SIZE || bmp.height > MAX_IMAGE_SIZE) return;
 
     // Attempt to create image
-    m_load_image_stack.push_back(image_data);
-    createImage(bmp);
+    std::vector<std::shared_ptr<ImageJob>> jobs { std::make_shared<ImageJob>(image_data) };
+    jobs[0]->image = createImage(image_data, bmp);
+    finishImages(jobs);
 }
 
-// Initiates fetch of next image from the load stack
+// Initiates fetches of images from the load stack, one per free fetch slot (sokol_fetch channel lane)
 void DrImageManager::processFetchStack() {
-    if (m_loading_image || m_load_image_stack.size() < 1) return;
-    m_loading_image = true;
+    if (m_load_image_stack.size() < 1) return;
+
+    // One slot per lane of every channel, slot 'i' always fetches on channel 'i % channels'
+    if (m_fetch_slots.empty()) {
+        sfetch_desc_t fetch_desc = sfetch_desc();
+        m_fetch_channels = Max(1, static_cast<int>(fetch_desc.num_channels));
+        m_fetch_slots.resize(m_fetch_channels * Max(1, static_cast<int>(fetch_desc.num_lanes)));
+    }
+
+    for (int slot = 0; slot < static_cast<int>(m_fetch_slots.size()); ++slot) {
+        if (m_load_image_stack.size() < 1) return;
+        if (m_fetch_slots[slot].job == nullptr) startFetch(slot);
+    }
+}
+
+// Starts fetch of next image from the load stack into 'slot'
+void DrImageManager::startFetch(int slot) {
+    ImageFetchSlot& fetch_slot = m_fetch_slots[slot];
+    if (fetch_slot.buffer.empty()) fetch_slot.buffer.resize(MAX_FILE_SIZE);
+
+    // Job is queued now so images are finished in the order they were requested, whichever fetch completes first
+    fetch_slot.job = std::make_shared<ImageJob>(m_load_image_stack[0]);
+    m_image_jobs.push_back(fetch_slot.job);
+    m_load_image_stack.pop_front();
 
     bool already_handled_fetch = false;
     #if defined(DROP_TARGET_HTML5)
-        if (m_load_image_stack[0].was_dropped == true) {
+        if (fetch_slot.job->load_data.was_dropped == true) {
             sapp_html5_fetch_request sokol_fetch_request { };
                 sokol_fetch_request.dropped_file_index = 0;
-                sokol_fetch_request.buffer_ptr = m_load_image_buffer;
-                sokol_fetch_request.buffer_size = sizeof(m_load_image_buffer);
+                sokol_fetch_request.buffer_ptr = fetch_slot.buffer.data();
+                sokol_fetch_request.buffer_size = fetch_slot.buffer.size();
+                sokol_fetch_request.user_data = reinterpret_cast<void*>(static_cast<intptr_t>(slot));
                 sokol_fetch_request.callback = +[](const sapp_html5_fetch_response* response) {
-                    // Load Data from response
-                    DrBitmap bmp((unsigned char*)response->buffer_ptr, (int)response->fetched_size);
-
-                    // Image dimensions too large! Max width and height are MAX_IMAGE_SIZE!"
-                    if (bmp.width > MAX_IMAGE_SIZE || bmp.height > MAX_IMAGE_SIZE) {
-                        bmp = DrBitmap(0, 0);
-                    }
-
                     // Could check for errors...
                     if (response->error_code == SAPP_HTML5_FETCH_ERROR_BUFFER_TOO_SMALL     /* '1' */) { }
 
-                    // Attempt to create image
-                    App()->imageManager()->createImage(bmp);
+                    // Create image from response data in the background
+                    int slot = static_cast<int>(reinterpret_cast<intptr_t>(response->user_data));
+                    App()->imageManager()->queueImageJob(slot, (unsigned char*)response->buffer_ptr, (int)response->fetched_size);
                 };
             sapp_html5_fetch_dropped_file(&sokol_fetch_request);
             already_handled_fetch = true;
@@ -120,30 +184,121 @@ void DrImageManager::processFetchStack() {
 
     if (already_handled_fetch == false) {
         sfetch_request_t sokol_fetch_image { };
-            sokol_fetch_image.path = m_load_image_stack[0].image_file.c_str();
-            sokol_fetch_image.buffer_ptr = m_load_image_buffer;
-            sokol_fetch_image.buffer_size = sizeof(m_load_image_buffer);
+            sokol_fetch_image.channel = static_cast<uint32_t>(slot % m_fetch_channels);
+            sokol_fetch_image.path = fetch_slot.job->load_data.image_file.c_str();
+            sokol_fetch_image.buffer_ptr = fetch_slot.buffer.data();
+            sokol_fetch_image.buffer_size = fetch_slot.buffer.size();
+            sokol_fetch_image.user_data_ptr = &slot;
+            sokol_fetch_image.user_data_size = sizeof(slot);
             sokol_fetch_image.callback = +[](const sfetch_response_t* response) {
-                // Load Data from response
-                DrBitmap bmp((unsigned char*)response->buffer_ptr, (int)response->fetched_size);
-
-                // Image dimensions too large! Max width and height are MAX_IMAGE_SIZE!"
-                if (bmp.width > MAX_IMAGE_SIZE || bmp.height > MAX_IMAGE_SIZE) {
-                    bmp = DrBitmap(0, 0);
-                }
+                if (response->finished == false) return;
 
                 // Could check for errors...
                 if (response->error_code == SFETCH_ERROR_FILE_NOT_FOUND     /* '1' */) { }
                 if (response->error_code == SFETCH_ERROR_BUFFER_TOO_SMALL   /* '3' */) { }
 
-                // Attempt to create image
-                App()->imageManager()->createImage(bmp);
+                // Create image from response data in the background
+                int slot = *static_cast<int*>(response->user_data);
+                int size = (response->failed) ? 0 : static_cast<int>(response->fetched_size);
+                App()->imageManager()->queueImageJob(slot, (unsigned char*)response->buffer_ptr, size);
             };
         sfetch_send(&sokol_fetch_image);
     }
 }
 
 
+//####################################################################################
+//##    Background Jobs
+//##        Fetched images are decoded, premultiplied, outlined (and passed to ImageLoadData::prepare) on the
+//##        thread pool, then finished on the frame thread in the order they were requested. Without worker
+//##        threads (ex: Html5) jobs run immediately on the calling thread
+//####################################################################################
+// Copies fetched file data (slot buffer is reused by next fetch) and creates image from it on the thread pool
+void DrImageManager::queueImageJob(int slot, const unsigned char* file_data, int file_size) {
+    std::shared_ptr<ImageJob> job = m_fetch_slots[slot].job;
+    if (file_data != nullptr && file_size > 0) job->file_data.assign(file_data, file_data + file_size);
+    m_fetch_slots[slot].job = nullptr;
+
+    auto work = [job]() {
+        // Load Data from file, image dimensions too large! Max width and height are MAX_IMAGE_SIZE!
+        DrBitmap bmp(0, 0);
+        if (job->file_data.empty() == false) {
+            bmp = DrBitmap(job->file_data.data(), static_cast<int>(job->file_data.size()));
+        }
+        if (bmp.width > MAX_IMAGE_SIZE || bmp.height > MAX_IMAGE_SIZE) {
+            bmp = DrBitmap(0, 0);
+        }
+        std::vector<unsigned char>().swap(job->file_data);
+
+        // Attempt to create image
+        job->image = createImage(job->load_data, bmp);
+        job->finished.store(true);
+    };
+
+    DrThreadPool* pool = App()->threadPool();
+    if (pool == nullptr || pool->threadCount() == 0) {
+        work();
+    } else {
+        pool->submit(work, &m_job_counter);
+    }
+}
+
+// Finishes created images in request order, stops once 'm_upload_budget' pixels of gpu uploads have been queued this frame
+//      Every multi image Atlas changed since the last call (including by loadImage() / loadImages()) is uploaded whole
+//      at the end (see uploadAtlas()), so each changed Atlas is charged its full width * height. Single image Atlases
+//      are charged their (power of 2) Atlas size. Batches are finished all at once when every image in them is ready.
+//      At least one image (or batch) is finished per frame, so uploads larger than the budget still happen
+void DrImageManager::processUploads() {
+    // Pixels of multi image Atlases that will be uploaded at the end of this frame, Atlases can grow while packing
+    auto dirty_atlas_pixels = [this]() {
+        int pixels = 0;
+        for (auto& pair : m_atlas_multi) {
+            if (pair.second->needs_upload) pixels += pair.second->width * pair.second->height;
+        }
+        return pixels;
+    };
+
+    int  single_pixels = 0;
+    bool finished_some = false;
+    while (m_image_jobs.empty() == false && (finished_some == false || single_pixels + dirty_atlas_pixels() < m_upload_budget)) {
+        // Find jobs to finish together, next image or whole batch
+        int    batch = m_image_jobs[0]->load_data.batch;
+        size_t count = 1;
+        bool   ready = true;
+        if (batch != 0) {
+            while (count < m_image_jobs.size() && m_image_jobs[count]->load_data.batch == batch) ++count;
+            bool batch_fetching = (count == m_image_jobs.size() && m_load_image_stack.size() > 0 && m_load_image_stack[0].batch == batch);
+            if (batch_fetching) ready = false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (m_image_jobs[i]->finished.load() == false) ready = false;
+        }
+        if (ready == false) break;
+
+        // Finish them, single image Atlases are uploaded as they are created
+        std::vector<std::shared_ptr<ImageJob>> jobs(m_image_jobs.begin(), m_image_jobs.begin() + count);
+        m_image_jobs.erase(m_image_jobs.begin(), m_image_jobs.begin() + count);
+        for (auto& job : jobs) {
+            if (job->image != nullptr && job->load_data.atlas_type == ATLAS_TYPE_SINGLE) {
+                int atlas_size = RoundPowerOf2(job->image->bitmap().maxDimension() + (job->load_data.padding*2));
+                single_pixels += atlas_size * atlas_size;
+            }
+        }
+        finishImages(jobs);
+        finished_some = true;
+    }
+
+    // Copy changed Atlases to gpu
+    uploadAtlases();
+}
+
+// Blocks until all image jobs on the thread pool are done (helps run them), used at shut down
+void DrImageManager::waitForJobs() {
+    DrThreadPool* pool = App()->threadPool();
+    if (pool != nullptr) pool->wait(m_job_counter);
+}
+
+
 //####################################################################################
 //##    Atlas Creation
 //####################################################################################
@@ -152,18 +307,17 @@ std::shared_ptr<DrAtlas>& DrImageManager::addAtlas(Atlas_Type atlas_type, int at
     // Create empty atlas
     std::shared_ptr<DrAtlas> atlas = std::make_shared<DrAtlas>();
         atlas->type = atlas_type;
-        atlas->width = atlas_size;
-        atlas->height = atlas_size;
         atlas->key = atlasKeys().getNextKey();
         atlas->gpu = sg_alloc_image().id;                                           // Alloc an image on the gpu
 
-    // Update image on gpu with new empty bitmap data
-    DrBitmap bitmap(atlas->width, atlas->height, DROP_BITMAP_FORMAT_ARGB);
-    sg_image_desc image_desc { };
-        initializeSgImageDesc(bitmap.width, bitmap.height, image_desc);
-        image_desc.data.subimage[0][0].ptr = &bitmap.data[0];
-        image_desc.data.subimage[0][0].size = static_cast<size_t>(bitmap.size());
-    sg_init_image({static_cast<uint32_t>(atlas->gpu)}, &image_desc);
+    // Single image Atlas texture is created from the image once it is placed, see uploadSingleAtlas()
+    if (atlas_type == ATLAS_TYPE_SINGLE) {
+        atlas->width =  atlas_size;
+        atlas->height = atlas_size;
+    } else {
+        atlas->packer = std::make_shared<DrAtlasPacker>(atlas_size);
+        resizeAtlas(atlas, atlas_size);
+    }
 
     // Add to atlases
     if (atlas_type == ATLAS_TYPE_SINGLE) {
@@ -175,6 +329,22 @@ std::shared_ptr<DrAtlas>& DrImageManager::addAtlas(Atlas_Type atlas_type, int at
     }
 }
 
+// Sets multi image Atlas size and (re)inits dynamic gpu texture to match its packer, previous gpu contents are discarded
+void DrImageManager::resizeAtlas(std::shared_ptr<DrAtlas>& atlas, int atlas_size) {
+    atlas->width =  atlas_size;
+    atlas->height = atlas_size;
+
+    // Dynamic texture, contents are copied from shadow copy by uploadAtlas()
+    if (sg_query_image_info({static_cast<uint32_t>(atlas->gpu)}).slot.state == SG_RESOURCESTATE_VALID) {
+        sg_uninit_image({static_cast<uint32_t>(atlas->gpu)});
+    }
+    sg_image_desc image_desc { };
+        initializeSgImageDesc(atlas->width, atlas->height, image_desc);
+        image_desc.usage = SG_USAGE_DYNAMIC;
+    sg_init_image({static_cast<uint32_t>(atlas->gpu)}, &image_desc);
+    atlas->needs_upload = true;
+}
+
 
 //####################################################################################
 //##    Atlas Finding
@@ -210,140 +380,136 @@ void DrImageManager::findAtlasForImage(ImageLoadData& image_data) {
 //####################################################################################
 //##    Atlas Packing
 //####################################################################################
-// Runs stb rect pack on collection of images and attempts to pack them onto an atlas
-bool DrImageManager::packAtlas(std::shared_ptr<DrAtlas>& atlas, std::vector<stbrp_rect>& rects) {
-    // If multi image atlas, pack rects
-    if (atlas->type != ATLAS_TYPE_SINGLE) {
-        std::vector<stbrp_node> nodes(atlas->maxDimension() * 2);
-        stbrp_context rect_pack { };
-        stbrp_init_target(&rect_pack, atlas->width, atlas->height, &nodes[0], nodes.size());
-        stbrp_pack_rects(&rect_pack, &rects[0], rects.size());
-
-        // Test that all rects were packed
-        bool packed = true;
-        for (int i = 0; i < rects.size(); ++i) {
-            if (rects[i].was_packed == 0) packed = false;
-        }
-        return packed;
-    } else {
-        return true;
-    }
-}
-
 // Attempts to put an Image onto an Atlas, returns true if successful
+//      Multi image Atlas: image is packed into space left by the Atlas packer, if it doesn't fit the Atlas is grown,
+//      every image on it is repacked and the gpu texture is recreated at the new size (see DrAtlasPacker::add())
 bool DrImageManager::addImageToAtlas(ImageLoadData& image_data, std::shared_ptr<DrAtlas>& atlas) {
-    // Add image to list of atlas image keys, if checks don't pass below this will be removed
-    atlas->packed_image_keys.push_back(image_data.image->key());
-
-    // Fill rects with image data
-    std::vector<stbrp_rect> rects(atlas->packed_image_keys.size());
-    for (int i = 0; i < rects.size(); ++i) {
-        setStbRect(rects[i], m_images[atlas->packed_image_keys[i]]);
+    std::shared_ptr<DrImage>& img = image_data.image;
+
+    // Single image atlas
+    if (atlas->type == ATLAS_TYPE_SINGLE) {
+        stbrp_rect rect;
+        setStbRect(rect, img);
+        atlas->packed_image_keys.push_back(img->key());
+        placeImage(atlas, img, rect);
+        uploadSingleAtlas(atlas, img);
+        return true;
     }
 
-    // If multi image atlas, test if new image fits
-    bool packed = false;
-    if (image_data.atlas_type != ATLAS_TYPE_SINGLE) {
-        // If enough pixels avaiable, first try full repack
-        int number_of_pixels = (image_data.image->bitmap().width + image_data.padding) * (image_data.image->bitmap().height + image_data.padding);
-        if (number_of_pixels <= atlas->availablePixels()) {
-            packed = packAtlas(atlas, rects);
+    // Multi image atlas
+    int max_size = Min(sg_query_limits().max_image_size_2d, MAX_ATLAS_SIZE);
+    Atlas_Pack_Result result = atlas->packer->add(img->key(), img->bitmap(), img->padding(), max_size);
+    if (result == ATLAS_PACK_FAILED) return false;
+    atlas->packed_image_keys.push_back(img->key());
+    const std::vector<DrAtlasSlot>& slots = atlas->packer->slots();
+    if (result == ATLAS_PACK_GREW) {
+        resizeAtlas(atlas, atlas->packer->size());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            placeImage(atlas, m_images[slots[i].key], slots[i].rect);
         }
+    } else {
+        placeImage(atlas, img, slots.back().rect);
+    }
+    atlas->needs_upload = true;
+    return true;
+}
 
-        // If not packed, try to increase Atlas size
-        if (packed == false) {
-            // Find size that will fit existing atlas plus new image
-            int atlas_x2 =  atlas->maxDimension() * 2;
-            int min_dimen = atlas->maxDimension() + image_data.image->bitmap().minDimension();
-            int max_dimen = image_data.image->bitmap().maxDimension();
-            int size_needed = 0;
-            if ((min_dimen <= atlas_x2) && (max_dimen <= atlas_x2)) {
-                size_needed = Max(min_dimen, max_dimen);
-            } else {
-                size_needed = atlas->maxDimension() + image_data.image->bitmap().maxDimension();
-            }
+// Sets position / uvs of image packed at 'rect', pixels are copied by the Atlas packer (or uploadSingleAtlas())
+void DrImageManager::placeImage(std::shared_ptr<DrAtlas>& atlas, std::shared_ptr<DrImage>& img, const stbrp_rect& rect) {
+    // Update image gpu texture id to match Atlas
+    img->setGpuID(atlas->gpu);
+
+    // Atlas position
+    int left =      rect.x + img->padding();
+    int top =       rect.y + img->padding();
+    int right =     rect.x + rect.w - img->padding()*2;
+    int bottom =    rect.y + rect.h - img->padding()*2;
+    img->setTopLeft(left, top);
+    img->setBottomRight(right, bottom);
+
+    // Update uv texture coordinates
+    float x0 = static_cast<float>(left) / static_cast<float>(atlas->width);
+    float y0 = static_cast<float>(top)  / static_cast<float>(atlas->height);
+    float x1 = static_cast<float>(right)  / static_cast<float>(atlas->width);
+    float y1 = static_cast<float>(bottom) / static_cast<float>(atlas->height);
+    img->setUv0(x0, y0);
+    img->setUv1(x1, y1);
+}
 
-            // If needed size is within hardware limits, increase atlas size, repack
-            if (size_needed <= sg_query_limits().max_image_size_2d && size_needed <= MAX_ATLAS_SIZE) {
-                int resize_atlas = RoundPowerOf2(size_needed);
-                atlas->width = resize_atlas;
-                atlas->height = resize_atlas;
-            } else {
-                atlas->packed_image_keys.pop_back();
-                return false;
-            }
-        }
-    }
 
-    // If atlas was resized, or not packed yet, pack atlas now
-    if (packed == false) {
-        packAtlas(atlas, rects);
-    }
+//####################################################################################
+//##    Atlas Uploading
+//####################################################################################
+// Copies shadow copy of multi image Atlas to its gpu texture
+//      !!!!! #NOTE: Sokol has no sub-rect texture updates, so every upload copies the whole Atlas (width * height * 4
+//                   bytes, 64MB for a 4096 x 4096 Atlas) no matter how small the images added since the last upload
+//                   were. Sokol also allows one update per image per frame, only uploadAtlases() should call this
+void DrImageManager::uploadAtlas(std::shared_ptr<DrAtlas>& atlas) {
+    sg_image_data image_data { };
+        image_data.subimage[0][0].ptr = &atlas->packer->shadow().data[0];
+        image_data.subimage[0][0].size = static_cast<size_t>(atlas->packer->shadow().size());
+    sg_update_image({static_cast<uint32_t>(atlas->gpu)}, &image_data);
+    atlas->needs_upload = false;
+}
 
-    // Copy image pixel data to atlas
-    DrBitmap bitmap(atlas->width, atlas->height, DROP_BITMAP_FORMAT_ARGB);
-    atlas->pixels_used = 0;
-    for (int i = 0; i < atlas->packed_image_keys.size(); ++i) {
-        std::shared_ptr<DrImage>& img = m_images[rects[i].id];
-        DrRect source_rect = img->bitmap().rect();
-        DrPoint dest_point = DrPoint(rects[i].x + img->padding(), rects[i].y + img->padding());
-        DrBitmap::Blit(img->bitmap(), source_rect, bitmap, dest_point);
-
-        // Add rect pixels to variable tracking how many pixels have been filled
-        int number_of_pixels = (img->bitmap().width + img->padding()*2) * (img->bitmap().height + img->padding()*2);
-        atlas->pixels_used += number_of_pixels;
-
-        // Update image gpu texture id to match Atlas
-        img->setGpuID(atlas->gpu);
-
-        // Atlas position
-        int left =      rects[i].x + img->padding();
-        int top =       rects[i].y + img->padding();
-        int right =     rects[i].x + rects[i].w - img->padding()*2;
-        int bottom =    rects[i].y + rects[i].h - img->padding()*2;
-        img->setTopLeft(left, top);
-        img->setBottomRight(right, bottom);
-
-        // Update uv texture coordinates
-        float x0 = static_cast<float>(left) / static_cast<float>(bitmap.width);
-        float y0 = static_cast<float>(top)  / static_cast<float>(bitmap.height);
-        float x1 = static_cast<float>(right)  / static_cast<float>(bitmap.width);
-        float y1 = static_cast<float>(bottom) / static_cast<float>(bitmap.height);
-        img->setUv0(x0, y0);
-        img->setUv1(x1, y1);
+// Uploads every multi image Atlas that has had images packed onto it since it was last uploaded, called once per
+// frame by processUploads() so images added during the frame share a single upload per Atlas
+void DrImageManager::uploadAtlases() {
+    for (auto& pair : m_atlas_multi) {
+        if (pair.second->needs_upload) uploadAtlas(pair.second);
     }
+}
 
-    // Update image on gpu with new bitmap data
-    if (sg_query_image_info({static_cast<uint32_t>(atlas->gpu)}).slot.state == SG_RESOURCESTATE_VALID) {
-        sg_uninit_image({static_cast<uint32_t>(atlas->gpu)});
+// Creates immutable gpu texture of single image Atlas from its image, no shadow copy is kept
+//      Image bitmap is used as is when it fills the Atlas, otherwise it is copied (with padding) into a temporary bitmap
+void DrImageManager::uploadSingleAtlas(std::shared_ptr<DrAtlas>& atlas, std::shared_ptr<DrImage>& img) {
+    const DrBitmap* pixels = &img->bitmap();
+    DrBitmap padded;
+    if (pixels->width != atlas->width || pixels->height != atlas->height || pixels->channels != 4) {
+        padded = DrBitmap(atlas->width, atlas->height, DROP_BITMAP_FORMAT_ARGB);
+        CopyIntoAtlas(img->bitmap(), padded, img->padding(), img->padding());
+        pixels = &padded;
     }
     sg_image_desc image_desc { };
-        initializeSgImageDesc(bitmap.width, bitmap.height, image_desc);
-        image_desc.data.subimage[0][0].ptr = &bitmap.data[0];
-        image_desc.data.subimage[0][0].size = static_cast<size_t>(bitmap.size());
+        initializeSgImageDesc(atlas->width, atlas->height, image_desc);
+        image_desc.data.subimage[0][0].ptr = &pixels->data[0];
+        image_desc.data.subimage[0][0].size = static_cast<size_t>(pixels->size());
     sg_init_image({static_cast<uint32_t>(atlas->gpu)}, &image_desc);
-
-    return true;
 }
 
 
-
 //####################################################################################
 //##    Image Creation
 //####################################################################################
-// Creates DrImage from DrBitmap from top of image loading stack, calls image callback function if there is one and image creation was successful
-void DrImageManager::createImage(DrBitmap& bmp) {
-    // Image data
-    ImageLoadData& image_data = m_load_image_stack[0];
-
+// Creates DrImage from DrBitmap, returns nullptr if bitmap is not valid. Safe to call from worker threads
+//      !!!!! #NOTE: Premultiplies alpha of 'bmp' in place
+std::shared_ptr<DrImage> DrImageManager::createImage(const ImageLoadData& image_data, DrBitmap& bmp) {
     // Only create image if bitmap is valid
-    if (bmp.isValid()) {
+    if (bmp.isValid() == false) return nullptr;
+
+    // Create DrImage, bitmap is premultiplied in place
+    static const DrFilterPipeline premultiply = DrFilterPipeline().add(DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA);
+    premultiply.apply(bmp);
+    std::shared_ptr<DrImage> image = std::make_shared<DrImage>(image_data.image_file, bmp, image_data.outline);
+
+    // If there is a prepare function (cpu work such as building a mesh), call it now
+    if (image_data.prepare != NULL) {
+        image_data.prepare(image);
+    }
+    return image;
+}
+
+// Adds created images to Image Manager, packs them onto Atlases, then calls image callback functions
+//      Multi image Atlases are uploaded once per frame by processUploads(), single image Atlases are created here
+//      !!!!! #NOTE: Must be called from the frame thread
+void DrImageManager::finishImages(std::vector<std::shared_ptr<ImageJob>>& jobs) {
+    for (auto& job : jobs) {
+        ImageLoadData& image_data = job->load_data;
+        image_data.image = job->image;
+        if (image_data.image == nullptr) continue;
+
         // Key for new Image
         int new_image_key = imageKeys().getNextKey();
-
-        // Create DrImage
-        DrBitmap premultiplied = DrFilter::applySinglePixelFilter(DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA, bmp, 0);
-        image_data.image = std::make_shared<DrImage>(image_data.image_file, premultiplied, image_data.outline);
         image_data.image->setKey(new_image_key);
         image_data.image->setPadding(image_data.padding);
 
@@ -352,18 +518,14 @@ void DrImageManager::createImage(DrBitmap& bmp) {
 
         // Pack Image onto an Atlas, store Atlas gpu id on Image
         findAtlasForImage(image_data);
+    }
 
-        // If there is a callback function, call it now
-        if (image_data.callback != NULL) {
-            image_data.callback(image_data.image);
+    // If there are callback functions, call them now
+    for (auto& job : jobs) {
+        if (job->image != nullptr && job->load_data.callback != NULL) {
+            job->load_data.callback(job->image);
         }
-    } else {
-        image_data.image = nullptr;
     }
-
-    // Remove image of list to be fetched
-    m_load_image_stack.pop_front();
-    m_loading_image = false;
 }
 
 
@@ -11,14 +11,19 @@
 #define DR_APP_IMAGE_MANAGER_H
 
 // Include
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "engine/app/core/ThreadPool.h"
 #include "engine/data/Keys.h"
 
 // Forward Declarations
+class DrAssetPack;
+class DrAtlasPacker;
 class DrBitmap;
 class DrImage;
 
@@ -29,6 +34,9 @@ struct stbrp_rect;
 // Type Def / Using
 using ImageFunction = std::function<void(std::shared_ptr<DrImage>&)>;
 
+// Local Defines
+#define IMAGE_UPLOAD_BUDGET     (2048 * 2048)                                       // Default pixels uploaded to gpu per frame (changed Atlases count whole)
+
 // Enums
 enum Atlas_Type {
     ATLAS_TYPE_SINGLE,                                                              // Store image on gpu by itself, not in atlas with other images
@@ -52,10 +60,10 @@ public:
     int                         key                     { KEY_NONE };               // Image Manager unique indentifier for this Atlas
     int                         gpu                     { KEY_NONE };               // Texture ID (Atlas in gpu memory)
     std::vector<int>            packed_image_keys       { };                        // Images (image keys) packed onto this Atlas
-    int                         pixels_used             { 0 };                      // Total number of pixels used up by Images packed onto this Atlas
+    bool                        needs_upload            { false };                  // True when shadow copy has changed since Atlas was last copied to gpu
+    std::shared_ptr<DrAtlasPacker>  packer              { nullptr };                // Packer / shadow copy of multi image Atlas, see AtlasPacker.h
 
     // Functions
-    int         availablePixels()       { return ((width * height) - pixels_used); }
     int         maxDimension() const    { return ((width > height) ? width : height); }
 };
 
@@ -65,14 +73,16 @@ public:
 //############################
 struct ImageLoadData {
     ImageLoadData(std::shared_ptr<DrImage>& load_to, std::string file, Atlas_Type atlas, int border_padding = 0,
-                  ImageFunction callback_func = NULL, bool perform_outline = false, bool drag_drop = false) :
+                  ImageFunction callback_func = NULL, bool perform_outline = false, bool drag_drop = false,
+                  ImageFunction prepare_func = NULL) :
         image(load_to),
         image_file(file),
         atlas_type(atlas),
         padding(border_padding),
         callback(callback_func),
         outline(perform_outline),
-        was_dropped(drag_drop)
+        was_dropped(drag_drop),
+        prepare(prepare_func)
     { }
     std::shared_ptr<DrImage>&       image;                                          // DrImage pointer to load new DrImage into after loading
     std::string                     image_file;                                     // File name and path on disk
@@ -81,6 +91,22 @@ struct ImageLoadData {
     ImageFunction                   callback;                                       // Function to call after loading
     bool                            outline;                                        // Should we run outline function on Image?
     bool                            was_dropped;                                    // Was this file dropped onto window?
+    ImageFunction                   prepare;                                        // Function to call on worker thread after image is created (no gpu calls!)
+    int                             batch           { 0 };                          // Batch key set by DrImageManager::fetchImages(), 0 if not part of a batch
+};
+
+
+//####################################################################################
+//##    Image Job
+//##        Fetched image being decoded / premultiplied / outlined on a worker thread,
+//##        finished (atlas packing, gpu upload, callback) on the frame thread by DrImageManager::processUploads()
+//############################
+struct ImageJob {
+    ImageJob(const ImageLoadData& data) : load_data(data) { }
+    ImageLoadData                   load_data;                                      // Load request this job was created from
+    std::vector<unsigned char>      file_data           { };                        // Fetched file, released once decoded
+    std::shared_ptr<DrImage>        image               { nullptr };                // Image created on worker thread, nullptr if image could not be loaded
+    std::atomic<bool>               finished            { false };                  // True once worker thread is done with job
 };
 
 
@@ -96,6 +122,12 @@ public:
     ~DrImageManager() { }
 
 private:
+    // #################### LOCAL STRUCTS ####################
+    struct ImageFetchSlot {
+        std::vector<uint8_t>        buffer      { };                                // Buffer to fetch image into, allocated (MAX_FILE_SIZE) on first fetch
+        std::shared_ptr<ImageJob>   job         { nullptr };                        // Job of image being fetched, nullptr when slot is free
+    };
+
     // #################### VARIABLES ####################
     // Key Generators
     DrKeys          m_atlas_keys             { };                                   // Key generator for Game Assets
@@ -109,9 +141,15 @@ private:
     std::unordered_map<int, std::shared_ptr<DrImage>>   m_images;                   // Keeps list of loaded images, stored by DrImage key
 
     // Fetching Variables
-    uint8_t                         m_load_image_buffer[MAX_FILE_SIZE];             // Buffer to use to load images
+    std::vector<ImageFetchSlot>     m_fetch_slots           { };                    // One per sokol_fetch channel lane, allocated on first fetch
+    int                             m_fetch_channels        { 1 };                  // Number of sokol_fetch channels slots are spread across
     std::deque<ImageLoadData>       m_load_image_stack      { };                    // Stack of images to fetch
-    bool                            m_loading_image         { false };              // True when waiting for fetch to complete
+    int                             m_next_batch            { 1 };                  // Next batch key handed out by fetchImages()
+
+    // Background Jobs
+    std::deque<std::shared_ptr<ImageJob>>   m_image_jobs    { };                    // Fetched images being created on worker threads, in order fetched
+    DrJobCounter                    m_job_counter           { };                    // Tracks image jobs still running on the thread pool
+    int                             m_upload_budget         { IMAGE_UPLOAD_BUDGET };// Pixels of gpu uploads per frame, see processUploads()
 
 public:
     // #################### FUNCTIONS ####################
@@ -124,20 +162,38 @@ public:
 
     // Image Loading
     void        fetchImage(ImageLoadData image_data);
+    void        fetchImages(std::vector<ImageLoadData> batch);
     void        loadImage(ImageLoadData image_data);
+    void        loadImages(std::vector<ImageLoadData> batch);
+    void        loadImageFromPack(const DrAssetPack& pack, ImageLoadData image_data);
     void        processFetchStack();
+    void        processUploads();
+    void        waitForJobs();
+
+    // Upload Budget
+    int         uploadBudget()                  { return m_upload_budget; }
+    void        setUploadBudget(int pixels)     { m_upload_budget = pixels; }
 
 private:
     // Atlas Creation
     std::shared_ptr<DrAtlas>&   addAtlas(Atlas_Type atlas_type, int atlas_size);
+    void                        resizeAtlas(std::shared_ptr<DrAtlas>& atlas, int atlas_size);
     void                        findAtlasForImage(ImageLoadData& image_data);
 
     // Atlas Packing
     bool                        addImageToAtlas(ImageLoadData& image_data, std::shared_ptr<DrAtlas>& atlas);
-    bool                        packAtlas(std::shared_ptr<DrAtlas>& atlas, std::vector<stbrp_rect>& rects);
+    void                        placeImage(std::shared_ptr<DrAtlas>& atlas, std::shared_ptr<DrImage>& img, const stbrp_rect& rect);
+
+    // Atlas Uploading
+    void                        uploadAtlas(std::shared_ptr<DrAtlas>& atlas);
+    void                        uploadAtlases();
+    void                        uploadSingleAtlas(std::shared_ptr<DrAtlas>& atlas, std::shared_ptr<DrImage>& img);
 
     // Image Creation
-    void                        createImage(DrBitmap& bmp);
+    static std::shared_ptr<DrImage> createImage(const ImageLoadData& image_data, DrBitmap& bmp);
+    void                        finishImages(std::vector<std::shared_ptr<ImageJob>>& jobs);
+    void                        queueImageJob(int slot, const unsigned char* file_data, int file_size);
+    void                        startFetch(int slot);
 
     // Key Gen
     DrKeys&     atlasKeys()     { return m_atlas_keys; }
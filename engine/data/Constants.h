@@ -19,13 +19,18 @@
 
 #define KEY_NONE                    0                               // Value that represents no item selected
 #define KEY_START                   1                               // Starting value for key generators
+#define INDEX_NONE           SIZE_MAX                               // Value that represents no array index (empty slot in a sparse set)
 
 #define MAX_FILE_SIZE     1024 * 1024                               // Used for filebuffers with sokol_fetch
 #define MAX_IMAGE_SIZE           2048                               // Max image size for gpu images, 2048 should support 99.9% of devices from year 2010 on
 #define MAX_ATLAS_SIZE           8192                               // Stop stb rect pack from working too hard (2048, 4096, 8192, 16384, 32768, etc, also depends on hardware)
 #define ATLAS_PADDING               1                               // Padding of empty pixels added around Images before they are copied onto Atlas
 
-#define MAX_ENTITIES            10000                               // Total of number of entities allowed for now
+#define ENTITY_INDEX_BITS          20                               // Low bits of an EntityID are the Entity slot index, bits above are the slot version
+#define ENTITY_INDEX_MASK  0x000FFFFFu                              // Mask of EntityID index bits
+#define MAX_ENTITIES  ENTITY_INDEX_MASK                             // Limit of Entity index bits (~1M), ECS storage is paged and only grows as Entities are created
+#define ENTITY_VERSION_MASK    0x07FFu                              // Mask of EntityID version bits (after shift), top bit of EntityID is reserved for DrCommandBuffer
+                                                                    // ...a slot is retired after its last version instead of wrapping (see DrEntityManager)
 #define MAX_COMPONENTS             32                               // Current maximum number of compoenents (uint_8), used for sizing Signature
 
 // !!!!! #TEMP
@@ -42,5 +47,11 @@ using Archetype =           std::bitset<MAX_COMPONENTS>;            // A bitset
 using ArrayIndex = 		    size_t;                                 // For referencing Array subscript values
 using HashID =              size_t;                                 // This comes from typeid(OBJECT).hash_code() ... identical to Reflect.h's 'TypeHash'
 
+// EntityID Helpers, an EntityID is a generational handle: [ reserved (1 bit) | version (11 bits) | index (20 bits) ]
+inline EntityID GetEntityIndex(EntityID entity)                         { return (entity & ENTITY_INDEX_MASK); }
+inline EntityID GetEntityVersion(EntityID entity)                       { return ((entity >> ENTITY_INDEX_BITS) & ENTITY_VERSION_MASK); }
+inline EntityID MakeEntityID(EntityID index, EntityID version)          { return (index & ENTITY_INDEX_MASK) | ((version & ENTITY_VERSION_MASK) << ENTITY_INDEX_BITS); }
+static_assert(MAX_ENTITIES <= ENTITY_INDEX_MASK, "MAX_ENTITIES does not fit in EntityID index bits!");
+
 
 #endif  // DR_ENGINE_CONSTANTS_H
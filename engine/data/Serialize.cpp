@@ -0,0 +1,529 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include "engine/app/core/Reflect.h"
+#include "engine/data/Constants.h"
+#include "engine/ecs/Coordinator.h"
+#include "Serialize.h"
+
+// Local Defines
+#define SCENE_FILE_ALIGN            16                                          // Raw Component arrays start on this byte alignment (from start of scene)
+
+
+//####################################################################################
+//##    Local Structs
+//####################################################################################
+struct DrSceneHeader {
+    char                magic[4];
+    std::uint32_t       drop_version;                                           // DROP_VERSION of app that saved file
+    std::uint32_t       format_version;                                         // SCENE_FILE_FORMAT of app that saved file
+    std::uint32_t       entity_count;
+    std::uint32_t       section_count;
+    std::uint32_t       reserved;
+};
+
+// Member variable layout as it was when file was saved
+struct DrSavedMember {
+    std::string         name;
+    std::uint32_t       offset;
+    std::uint32_t       size;
+};
+
+// One Component section of a file, located during validation before anything is created
+struct DrSceneSection {
+    ComponentID                 component_id;                                   // COMPONENT_ID_NONE if Component is not registered
+    std::uint32_t               component_size;
+    bool                        raw;
+    std::vector<DrSavedMember>  members;
+    std::uint32_t               count;
+    const char*                 numbers;                                        // Entity number of each Component
+    const char*                 data;                                           // Component data
+    size_t                      data_length;
+};
+
+// Reads / writes value of one reflected member variable type
+struct DrMemberCodec {
+    bool                pod;                                                    // Type is trivially copyable
+    void                (*write)(std::vector<char>& buffer, const void* member);
+    bool                (*read)(const char* data, size_t length, void* member);
+};
+
+// Member variable layout of a registered Component as it is now
+struct DrMemberLayout {
+    const char*         name;
+    size_t              offset;
+    size_t              size;
+    const DrMemberCodec* codec;                                                 // nullptr if type has no codec, or member is from compile time table
+};
+
+
+//####################################################################################
+//##    Buffer Writing / Reading
+//####################################################################################
+static void WriteBytes(std::vector<char>& buffer, const void* data, size_t size) {
+    if (size == 0) return;
+    size_t at = buffer.size();
+    buffer.resize(at + size);
+    memcpy(&buffer[at], data, size);
+}
+
+template<typename T>
+static void WriteValue(std::vector<char>& buffer, const T& value) {
+    WriteBytes(buffer, &value, sizeof(T));
+}
+
+static void WriteString(std::vector<char>& buffer, const std::string& text) {
+    WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(text.size()));
+    WriteBytes(buffer, text.data(), text.size());
+}
+
+// Bounds checked reader, any read past end of data fails and leaves reader in failed state
+class DrSceneReader
+{
+private:
+    const char*     m_data;
+    size_t          m_size;
+    size_t          m_position      { 0 };
+    bool            m_ok            { true };
+
+public:
+    DrSceneReader(const char* data, size_t size) : m_data(data), m_size(size) { }
+
+    bool            ok() const                      { return m_ok; }
+    size_t          position() const                { return m_position; }
+
+    // Returns pointer to next 'size' bytes and advances, nullptr if not enough data
+    const char* skip(size_t size) {
+        if (m_ok == false || size > m_size - m_position) { m_ok = false; return nullptr; }
+        const char* at = m_data + m_position;
+        m_position += size;
+        return at;
+    }
+
+    template<typename T>
+    T value() {
+        T result { };
+        const char* at = skip(sizeof(T));
+        if (at) memcpy(&result, at, sizeof(T));
+        return result;
+    }
+
+    std::string string() {
+        std::uint32_t length = value<std::uint32_t>();
+        const char* at = skip(length);
+        return (at) ? std::string(at, length) : std::string();
+    }
+};
+
+
+//####################################################################################
+//##    Member Codecs
+//####################################################################################
+template<typename T>
+static void WritePod(std::vector<char>& buffer, const void* member) {
+    WriteBytes(buffer, member, sizeof(T));
+}
+template<typename T>
+static bool ReadPod(const char* data, size_t length, void* member) {
+    if (length != sizeof(T)) return false;
+    memcpy(member, data, sizeof(T));
+    return true;
+}
+
+template<typename T>
+static void WritePodVector(std::vector<char>& buffer, const void* member) {
+    const std::vector<T>& values = *static_cast<const std::vector<T>*>(member);
+    WriteBytes(buffer, values.data(), values.size() * sizeof(T));
+}
+template<typename T>
+static bool ReadPodVector(const char* data, size_t length, void* member) {
+    if (length % sizeof(T) != 0) return false;
+    std::vector<T>& values = *static_cast<std::vector<T>*>(member);
+    values.resize(length / sizeof(T));
+    if (length > 0) memcpy(values.data(), data, length);
+    return true;
+}
+
+static void WriteStringMember(std::vector<char>& buffer, const void* member) {
+    const std::string& text = *static_cast<const std::string*>(member);
+    WriteBytes(buffer, text.data(), text.size());
+}
+static bool ReadStringMember(const char* data, size_t length, void* member) {
+    static_cast<std::string*>(member)->assign(data, length);
+    return true;
+}
+
+static void WriteStringVector(std::vector<char>& buffer, const void* member) {
+    const std::vector<std::string>& values = *static_cast<const std::vector<std::string>*>(member);
+    WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(values.size()));
+    for (auto& text : values) WriteString(buffer, text);
+}
+static bool ReadStringVector(const char* data, size_t length, void* member) {
+    DrSceneReader reader(data, length);
+    std::vector<std::string>& values = *static_cast<std::vector<std::string>*>(member);
+    std::uint32_t count = reader.value<std::uint32_t>();
+    if (count > length / sizeof(std::uint32_t)) return false;
+    values.resize(count);
+    for (auto& text : values) text = reader.string();
+    return reader.ok();
+}
+
+// Codecs of supported member variable types (see Property_Type in Types.h), by TypeHash
+static const DrMemberCodec* FindMemberCodec(TypeHash type_hash) {
+    static const std::unordered_map<TypeHash, DrMemberCodec> codecs {
+        { TypeHashID<bool>(),                       { true,  &WritePod<bool>,               &ReadPod<bool> } },
+        { TypeHashID<char>(),                       { true,  &WritePod<char>,               &ReadPod<char> } },
+        { TypeHashID<std::int8_t>(),                { true,  &WritePod<std::int8_t>,        &ReadPod<std::int8_t> } },
+        { TypeHashID<std::uint8_t>(),               { true,  &WritePod<std::uint8_t>,       &ReadPod<std::uint8_t> } },
+        { TypeHashID<std::int16_t>(),               { true,  &WritePod<std::int16_t>,       &ReadPod<std::int16_t> } },
+        { TypeHashID<std::uint16_t>(),              { true,  &WritePod<std::uint16_t>,      &ReadPod<std::uint16_t> } },
+        { TypeHashID<std::int32_t>(),               { true,  &WritePod<std::int32_t>,       &ReadPod<std::int32_t> } },
+        { TypeHashID<std::uint32_t>(),              { true,  &WritePod<std::uint32_t>,      &ReadPod<std::uint32_t> } },
+        { TypeHashID<std::int64_t>(),               { true,  &WritePod<std::int64_t>,       &ReadPod<std::int64_t> } },
+        { TypeHashID<std::uint64_t>(),              { true,  &WritePod<std::uint64_t>,      &ReadPod<std::uint64_t> } },
+        { TypeHashID<float>(),                      { true,  &WritePod<float>,              &ReadPod<float> } },
+        { TypeHashID<double>(),                     { true,  &WritePod<double>,             &ReadPod<double> } },
+        { TypeHashID<std::string>(),                { false, &WriteStringMember,            &ReadStringMember } },
+        { TypeHashID<std::vector<int>>(),           { false, &WritePodVector<int>,          &ReadPodVector<int> } },
+        { TypeHashID<std::vector<unsigned int>>(),  { false, &WritePodVector<unsigned int>, &ReadPodVector<unsigned int> } },
+        { TypeHashID<std::vector<float>>(),         { false, &WritePodVector<float>,        &ReadPodVector<float> } },
+        { TypeHashID<std::vector<double>>(),        { false, &WritePodVector<double>,       &ReadPodVector<double> } },
+        { TypeHashID<std::vector<std::string>>(),   { false, &WriteStringVector,            &ReadStringVector } },
+    };
+    auto it = codecs.find(type_hash);
+    return (it == codecs.end()) ? nullptr : &it->second;
+}
+
+// Current member variables of a Component, from its compile time table (REFLECT_POD) when it has one (no g_reflect
+// lookups, Component is always written raw), otherwise from runtime reflection
+static std::vector<DrMemberLayout> ComponentMembers(DrCoordinator* ecs, ComponentID component_id) {
+    std::vector<DrMemberLayout> members;
+    const DrComponentInfo& info = ecs->getComponentInfo(component_id);
+    if (info.member_count > 0) {
+        for (int m = 0; m < info.member_count; ++m) {
+            members.push_back({ info.members[m].name, info.members[m].offset, info.members[m].size, nullptr });
+        }
+        return members;
+    }
+    TypeData& class_data = ClassData(ecs->getComponentHashID(component_id));
+    for (int m = 0; m < class_data.member_count; ++m) {
+        TypeData& member = MemberData(class_data.type_hash, m);
+        members.push_back({ member.name.c_str(), static_cast<size_t>(member.offset), member.size, FindMemberCodec(member.type_hash) });
+    }
+    return members;
+}
+
+
+//####################################################################################
+//##    Serialize
+//####################################################################################
+// Appends scene to 'buffer', returns false on failure
+bool SerializeScene(DrCoordinator* ecs, std::vector<char>& buffer) {
+    if (ecs == nullptr || g_reflect == nullptr) return false;
+
+    // ----- Number living Entities 0 to (Entity count - 1)
+    std::vector<std::uint32_t> entity_numbers;                                  // Entity index -> Entity number
+    std::uint32_t entity_count = 0;
+    ecs->eachEntity([&](EntityID entity) {
+        EntityID index = GetEntityIndex(entity);
+        if (index >= entity_numbers.size()) entity_numbers.resize(index + 1, 0);
+        entity_numbers[index] = entity_count++;
+    });
+
+    // ----- Header, section count is filled in at end
+    size_t header_at = buffer.size();
+    DrSceneHeader header { };
+        memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+        header.drop_version =   DROP_VERSION;
+        header.format_version = SCENE_FILE_FORMAT;
+        header.entity_count =   entity_count;
+    WriteValue(buffer, header);
+
+    // ----- One section per reflected Component type
+    for (ComponentID component_id = 0; component_id < ecs->componentCount(); ++component_id) {
+        TypeData& class_data = ClassData(ecs->getComponentHashID(component_id));
+        if (class_data.type_hash == 0) continue;                                // Not reflected, can't be matched by name when loading
+        const DrComponentInfo& info = ecs->getComponentInfo(component_id);
+        assert(info.align <= SCENE_FILE_ALIGN && "Component alignment too large for scene file!");
+
+        std::vector<DrMemberLayout> members = ComponentMembers(ecs, component_id);
+
+        std::uint32_t count = 0;
+        ecs->eachComponentData(component_id, [&](EntityID, void*) { ++count; });
+
+        WriteString(buffer, class_data.name);
+        WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(info.size));
+        WriteValue<std::uint8_t>(buffer, info.trivial ? 1 : 0);
+        WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(members.size()));
+        for (auto& member : members) {
+            WriteString(buffer, member.name);
+            WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(member.offset));
+            WriteValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(member.size));
+        }
+        WriteValue<std::uint32_t>(buffer, count);
+        size_t length_at = buffer.size();
+        WriteValue<std::uint64_t>(buffer, 0);
+        size_t data_start = buffer.size();
+
+        // Entity numbers
+        size_t at = buffer.size();
+        buffer.resize(at + (count * sizeof(std::uint32_t)));
+        ecs->eachComponentData(component_id, [&](EntityID entity, void*) {
+            memcpy(&buffer[at], &entity_numbers[GetEntityIndex(entity)], sizeof(std::uint32_t));
+            at += sizeof(std::uint32_t);
+        });
+
+        // Component data
+        if (info.trivial) {
+            size_t offset = buffer.size() - header_at;
+            buffer.resize(buffer.size() + ((SCENE_FILE_ALIGN - (offset % SCENE_FILE_ALIGN)) % SCENE_FILE_ALIGN), 0);
+            at = buffer.size();
+            buffer.resize(at + (count * info.size));
+            ecs->eachComponentBlock(component_id, [&](ArrayIndex block_count, void* components) {
+                memcpy(&buffer[at], components, block_count * info.size);
+                at += block_count * info.size;
+            });
+        } else {
+            ecs->eachComponentData(component_id, [&](EntityID, void* component) {
+                for (size_t m = 0; m < members.size(); ++m) {
+                    size_t value_at = buffer.size();
+                    WriteValue<std::uint32_t>(buffer, 0);
+                    if (members[m].codec) members[m].codec->write(buffer, static_cast<char*>(component) + members[m].offset);
+                    std::uint32_t value_length = static_cast<std::uint32_t>(buffer.size() - value_at - sizeof(std::uint32_t));
+                    memcpy(&buffer[value_at], &value_length, sizeof(std::uint32_t));
+                }
+            });
+        }
+
+        std::uint64_t data_length = buffer.size() - data_start;
+        memcpy(&buffer[length_at], &data_length, sizeof(std::uint64_t));
+        ++header.section_count;
+    }
+
+    memcpy(&buffer[header_at], &header, sizeof(DrSceneHeader));
+    return true;
+}
+
+
+//####################################################################################
+//##    Deserialize
+//####################################################################################
+// Creates Entities / Components in 'ecs' from serialized scene, nothing is created if scene fails validation
+bool DeserializeScene(DrCoordinator* ecs, const char* data, size_t size) {
+    if (ecs == nullptr || data == nullptr || g_reflect == nullptr) return false;
+
+    DrSceneReader reader(data, size);
+    DrSceneHeader header = reader.value<DrSceneHeader>();
+    if (reader.ok() == false || memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.format_version != SCENE_FILE_FORMAT || header.drop_version > DROP_VERSION) return false;
+    if (header.entity_count > MAX_ENTITIES - ecs->entityCount()) return false;
+    if (header.section_count > size / sizeof(std::uint32_t)) return false;
+
+    // ----- Registered, reflected Components by class name
+    std::unordered_map<std::string, ComponentID> component_ids;
+    for (ComponentID component_id = 0; component_id < ecs->componentCount(); ++component_id) {
+        TypeData& class_data = ClassData(ecs->getComponentHashID(component_id));
+        if (class_data.type_hash != 0) component_ids[class_data.name] = component_id;
+    }
+
+    // ----- Locate / validate all sections before creating anything, each Component may only have one section
+    //       and each Entity may only appear once per section
+    std::vector<DrSceneSection> sections(header.section_count);
+    std::vector<bool> component_seen(ecs->componentCount(), false);
+    std::vector<bool> entity_seen(header.entity_count, false);
+    for (auto& section : sections) {
+        auto it = component_ids.find(reader.string());
+        section.component_id =      (it == component_ids.end()) ? COMPONENT_ID_NONE : it->second;
+        if (section.component_id != COMPONENT_ID_NONE) {
+            if (component_seen[section.component_id]) return false;
+            component_seen[section.component_id] = true;
+        }
+        section.component_size =    reader.value<std::uint32_t>();
+        section.raw =               reader.value<std::uint8_t>() != 0;
+        std::uint32_t member_count = reader.value<std::uint32_t>();
+        if (reader.ok() == false || member_count > (size - reader.position()) / sizeof(std::uint32_t)) return false;
+        section.members.resize(member_count);
+        for (auto& member : section.members) {
+            if (reader.ok() == false) return false;
+            member.name =   reader.string();
+            member.offset = reader.value<std::uint32_t>();
+            member.size =   reader.value<std::uint32_t>();
+            if (section.raw && member.offset + member.size > section.component_size) return false;
+        }
+        section.count =             reader.value<std::uint32_t>();
+        section.data_length =       static_cast<size_t>(reader.value<std::uint64_t>());
+        size_t data_start =         reader.position();
+        const char* section_data =  reader.skip(section.data_length);
+        if (section_data == nullptr) return false;
+
+        // Entity numbers, then (raw) aligned Component array
+        size_t numbers_length = section.count * sizeof(std::uint32_t);
+        if (numbers_length > section.data_length) return false;
+        section.numbers = section_data;
+        for (std::uint32_t i = 0; i < section.count; ++i) {
+            std::uint32_t number;
+            memcpy(&number, section.numbers + (i * sizeof(std::uint32_t)), sizeof(std::uint32_t));
+            if (number >= header.entity_count || entity_seen[number]) return false;
+            entity_seen[number] = true;
+        }
+        for (std::uint32_t i = 0; i < section.count; ++i) {
+            std::uint32_t number;
+            memcpy(&number, section.numbers + (i * sizeof(std::uint32_t)), sizeof(std::uint32_t));
+            entity_seen[number] = false;
+        }
+        size_t padding = 0;
+        if (section.raw) {
+            size_t offset = data_start + numbers_length;
+            padding = (SCENE_FILE_ALIGN - (offset % SCENE_FILE_ALIGN)) % SCENE_FILE_ALIGN;
+            if (numbers_length + padding + (static_cast<size_t>(section.count) * section.component_size) > section.data_length) return false;
+        }
+        section.data = section_data + numbers_length + padding;
+        section.data_length -= numbers_length + padding;
+    }
+
+    // ----- Create Entities, find full Archetype of each
+    std::vector<EntityID> entities(header.entity_count);
+    std::vector<Archetype> added(header.entity_count);
+    for (auto& entity : entities) entity = ecs->createEntity();
+    for (auto& section : sections) {
+        if (section.component_id == COMPONENT_ID_NONE) continue;
+        for (std::uint32_t i = 0; i < section.count; ++i) {
+            std::uint32_t number;
+            memcpy(&number, section.numbers + (i * sizeof(std::uint32_t)), sizeof(std::uint32_t));
+            added[number].set(section.component_id, true);
+        }
+    }
+
+    // ----- Archetype storage, move each Entity into the table of its final Archetype once (Entities sharing
+    //       an Archetype end up in consecutive rows), sections below fill in the table columns
+    bool archetype_storage = (ecs->storageMode() == ECS_STORAGE_ARCHETYPE);
+    if (archetype_storage) {
+        for (size_t i = 0; i < entities.size(); ++i) {
+            if (added[i].any()) ecs->moveComponentData(entities[i], added[i]);
+        }
+    }
+
+    // ----- Add Components, one section at a time
+    std::vector<EntityID> run_entities;
+    std::vector<const void*> run_data;
+    for (auto& section : sections) {
+        if (section.component_id == COMPONENT_ID_NONE) continue;
+        ComponentID component_id = section.component_id;
+        const DrComponentInfo& info = ecs->getComponentInfo(component_id);
+        std::vector<DrMemberLayout> members = ComponentMembers(ecs, component_id);
+
+        run_entities.resize(section.count);
+        for (std::uint32_t i = 0; i < section.count; ++i) {
+            std::uint32_t number;
+            memcpy(&number, section.numbers + (i * sizeof(std::uint32_t)), sizeof(std::uint32_t));
+            run_entities[i] = entities[number];
+        }
+
+        // Match saved members to current members by name
+        std::vector<const DrMemberLayout*> current(section.members.size(), nullptr);
+        bool same_layout = (section.raw && info.trivial && section.component_size == info.size &&
+                            section.members.size() == members.size());
+        for (size_t m = 0; m < section.members.size(); ++m) {
+            for (auto& member : members) {
+                if (section.members[m].name == member.name) { current[m] = &member; break; }
+            }
+            same_layout = same_layout && current[m] &&
+                          static_cast<std::uint32_t>(current[m]->offset) == section.members[m].offset &&
+                          static_cast<std::uint32_t>(current[m]->size) == section.members[m].size;
+        }
+
+        // Fast path, saved Components match current layout, copied straight out of 'data'
+        bool aligned = (reinterpret_cast<std::uintptr_t>(section.data) % info.align) == 0;
+        if (same_layout && aligned) {
+            if (archetype_storage) {
+                ecs->constructComponentArray(component_id, run_entities.data(), section.data, section.count);
+                continue;
+            }
+            run_data.resize(section.count);
+            for (std::uint32_t i = 0; i < section.count; ++i) run_data[i] = section.data + (static_cast<size_t>(i) * info.size);
+            ecs->insertComponentData(component_id, run_entities.data(), run_data.data(), section.count);
+            continue;
+        }
+
+        // Slow path, construct default Component, fill in matching members one by one
+        std::vector<std::max_align_t> temp_storage((info.size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) + 1);
+        void* temp = temp_storage.data();
+        DrSceneReader values(section.data, section.data_length);
+        for (std::uint32_t i = 0; i < section.count; ++i) {
+            info.construct(temp);
+            if (same_layout) {
+                memcpy(temp, section.data + (static_cast<size_t>(i) * info.size), info.size);
+            } else if (section.raw) {
+                const char* saved = section.data + (static_cast<size_t>(i) * section.component_size);
+                for (size_t m = 0; m < section.members.size(); ++m) {
+                    if (current[m] == nullptr || current[m]->size != section.members[m].size) continue;
+                    const DrMemberCodec* codec = current[m]->codec;
+                    if (info.trivial == false && (codec == nullptr || codec->pod == false)) continue;
+                    memcpy(static_cast<char*>(temp) + current[m]->offset, saved + section.members[m].offset, section.members[m].size);
+                }
+            } else {
+                for (size_t m = 0; m < section.members.size(); ++m) {
+                    std::uint32_t value_length = values.value<std::uint32_t>();
+                    const char* value = values.skip(value_length);
+                    if (value == nullptr || current[m] == nullptr) continue;
+                    if (current[m]->codec) current[m]->codec->read(value, value_length, static_cast<char*>(temp) + current[m]->offset);
+                }
+            }
+            const void* temp_data = temp;
+            if (archetype_storage) {
+                ecs->constructComponentData(component_id, &run_entities[i], &temp_data, 1);
+            } else {
+                ecs->insertComponentData(component_id, &run_entities[i], &temp_data, 1);
+            }
+            info.destroy(temp);
+        }
+    }
+
+    // ----- Update Archetypes / Systems once per Entity
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (added[i].any()) ecs->applyArchetypeChange(entities[i], added[i], Archetype());
+    }
+    return true;
+}
+
+
+//####################################################################################
+//##    Files
+//####################################################################################
+// Serializes scene and writes it to disk
+bool SaveScene(DrCoordinator* ecs, const std::string& file_path) {
+    std::vector<char> buffer;
+    if (SerializeScene(ecs, buffer) == false) return false;
+
+    FILE* file = fopen(file_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    size_t written = fwrite(buffer.data(), 1, buffer.size(), file);
+    fclose(file);
+    return (written == buffer.size());
+}
+
+// Reads scene file from disk and deserializes it into 'ecs'
+bool LoadScene(DrCoordinator* ecs, const std::string& file_path) {
+    FILE* file = fopen(file_path.c_str(), "rb");
+    if (file == nullptr) return false;
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_size <= 0) { fclose(file); return false; }
+
+    std::vector<char> buffer(static_cast<size_t>(file_size));
+    size_t read = fread(buffer.data(), 1, buffer.size(), file);
+    fclose(file);
+    if (read != buffer.size()) return false;
+    return DeserializeScene(ecs, buffer.data(), buffer.size());
+}
@@ -0,0 +1,52 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_DATA_SERIALIZE_H
+#define DR_DATA_SERIALIZE_H
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward Declarations
+class DrCoordinator;
+
+// Local Defines
+#define SCENE_FILE_MAGIC        "DRSC"                                          // First 4 bytes of a binary scene file
+#define SCENE_FILE_FORMAT            1                                          // Version of binary scene layout, bump when layout below changes
+
+
+//####################################################################################
+//##    Binary Scene Files
+//##        Saves / loads all Entities and reflected Components of a DrCoordinator
+//##
+//##        Layout (native byte order):
+//##            Header:     magic, DROP_VERSION, SCENE_FILE_FORMAT, Entity count, section count
+//##            Section:    (one per Component type)
+//##                - Component class name, byte size, 'raw' flag, member table (name, offset, size)
+//##                - Component count, byte size of remaining section data (so unknown Components can be skipped)
+//##                - Entity number (0 to Entity count - 1) of each Component
+//##                - Raw:      Trivially copyable Components, array of Components written with one memcpy
+//##                - Members:  Other Components, each reflected member written as (byte length, value)
+//##
+//##        - Components are matched by reflected class name, members by name, so files survive Component
+//##          layout changes (unmatched members keep their default value)
+//##        - Member tables come from a Component's compile time table (REFLECT_POD) when it has one, otherwise
+//##          from runtime reflection
+//##        - Components must be registered with the Coordinator and reflection must be initialized
+//##        - Entities are recreated on load, EntityIDs stored inside Components are NOT remapped
+//############################
+bool    SerializeScene(DrCoordinator* ecs, std::vector<char>& buffer);             // Appends scene to 'buffer', returns false on failure
+bool    DeserializeScene(DrCoordinator* ecs, const char* data, size_t size);        // Creates Entities / Components in 'ecs' from serialized scene
+bool    SaveScene(DrCoordinator* ecs, const std::string& file_path);                // Serializes scene and writes it to disk
+bool    LoadScene(DrCoordinator* ecs, const std::string& file_path);                // Reads scene file from disk and deserializes it into 'ecs'
+
+
+#endif  // DR_DATA_SERIALIZE_H
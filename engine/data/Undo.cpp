@@ -0,0 +1,227 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include "Undo.h"
+
+
+//####################################################################################
+//##    Local Structs
+//####################################################################################
+// Stored in arena before old bytes and new bytes of each change
+struct DrUndoChange {
+    EntityID            entity;
+    std::uint32_t       component_id;
+    std::uint32_t       offset;                                                 // Byte offset of member within Component
+    std::uint32_t       size;                                                   // Byte size of member
+};
+
+
+//####################################################################################
+//##    Constructor
+//####################################################################################
+DrUndoStack::DrUndoStack(DrCoordinator* ecs, size_t arena_size) :
+    m_ecs(ecs),
+    m_arena(arena_size)
+{ }
+
+
+//####################################################################################
+//##    Recording
+//####################################################################################
+void DrUndoStack::begin() {
+    assert(m_recording == false && "Undo transaction already started!");
+    m_recording = true;
+    m_pending.clear();
+    m_pending_count = 0;
+    m_touched.clear();
+    m_snapshots.clear();
+}
+
+// Snapshot Component before editing it in place, changed members are recorded during commit()
+void DrUndoStack::touch(EntityID entity, ComponentID component_id) {
+    assert(m_recording && "Undo transaction not started!");
+    const DrComponentInfo& info = m_ecs->getComponentInfo(component_id);
+    assert(info.trivial && "Only trivially copyable Components can be touched, use setMember() instead!");
+    for (auto& touched : m_touched) {
+        if (touched.entity == entity && touched.component_id == component_id) return;
+    }
+
+    DrUndoSnapshot snapshot;
+    snapshot.entity =       entity;
+    snapshot.component_id = component_id;
+    snapshot.offset =       m_snapshots.size();
+    m_snapshots.resize(m_snapshots.size() + info.size);
+    memcpy(&m_snapshots[snapshot.offset], m_ecs->getData(component_id, entity), info.size);
+    m_touched.push_back(snapshot);
+}
+
+// Adds change to transaction being recorded, does not apply it
+void DrUndoStack::recordChange(EntityID entity, ComponentID component_id, std::uint32_t offset, std::uint32_t size,
+                               const void* old_value, const void* new_value) {
+    assert(m_recording && "Undo transaction not started!");
+    appendChange(entity, component_id, offset, size, old_value, new_value);
+}
+
+void DrUndoStack::appendChange(EntityID entity, ComponentID component_id, std::uint32_t offset, std::uint32_t size,
+                               const void* old_value, const void* new_value) {
+    DrUndoChange change;
+    change.entity =         entity;
+    change.component_id =   component_id;
+    change.offset =         offset;
+    change.size =           size;
+
+    size_t at = m_pending.size();
+    m_pending.resize(at + sizeof(DrUndoChange) + size * 2);
+    memcpy(&m_pending[at], &change, sizeof(DrUndoChange));
+    memcpy(&m_pending[at + sizeof(DrUndoChange)], old_value, size);
+    memcpy(&m_pending[at + sizeof(DrUndoChange) + size], new_value, size);
+    ++m_pending_count;
+}
+
+// Diffs touched Components, then adds transaction to history, returns false if nothing changed
+bool DrUndoStack::commit() {
+    assert(m_recording && "Undo transaction not started!");
+    m_recording = false;
+
+    // Find changed members of touched Components, members come from the compile time table (REFLECT_POD) when the
+    // Component has one, otherwise from runtime reflection, Components without either are compared as a whole
+    for (auto& touched : m_touched) {
+        if (m_ecs->isAlive(touched.entity) == false) continue;
+        if (m_ecs->getEntityType(touched.entity).test(touched.component_id) == false) continue;
+        const char* before = &m_snapshots[touched.offset];
+        const char* after =  static_cast<const char*>(m_ecs->getData(touched.component_id, touched.entity));
+        const DrComponentInfo& info = m_ecs->getComponentInfo(touched.component_id);
+        if (info.member_count > 0) {
+            for (int i = 0; i < info.member_count; ++i) {
+                const PodMemberData& member = info.members[i];
+                if (memcmp(before + member.offset, after + member.offset, member.size) == 0) continue;
+                appendChange(touched.entity, touched.component_id, static_cast<std::uint32_t>(member.offset),
+                             static_cast<std::uint32_t>(member.size), before + member.offset, after + member.offset);
+            }
+            continue;
+        }
+        TypeHash class_hash = m_ecs->getComponentHashID(touched.component_id);
+        int member_count = ClassData(class_hash).member_count;
+        if (member_count == 0) {
+            std::uint32_t size = static_cast<std::uint32_t>(info.size);
+            if (memcmp(before, after, size) != 0) appendChange(touched.entity, touched.component_id, 0, size, before, after);
+            continue;
+        }
+        for (int i = 0; i < member_count; ++i) {
+            TypeData& member = MemberData(class_hash, i);
+            if (memcmp(before + member.offset, after + member.offset, member.size) == 0) continue;
+            appendChange(touched.entity, touched.component_id, static_cast<std::uint32_t>(member.offset),
+                         static_cast<std::uint32_t>(member.size), before + member.offset, after + member.offset);
+        }
+    }
+    m_touched.clear();
+    m_snapshots.clear();
+    if (m_pending_count == 0) return false;
+
+    // Recording a new transaction drops anything that could have been redone
+    while (m_transactions.size() > m_applied) m_transactions.pop_back();
+
+    // Transaction larger than whole history, older transactions no longer lead back to a consistent state
+    if (m_pending.size() > m_arena.size()) {
+        clear();
+        return true;
+    }
+
+    DrUndoTransaction transaction;
+    transaction.start =         allocate(m_pending.size());
+    transaction.bytes =         m_pending.size();
+    transaction.change_count =  m_pending_count;
+    memcpy(&m_arena[transaction.start], m_pending.data(), m_pending.size());
+    m_transactions.push_back(transaction);
+    m_applied = m_transactions.size();
+    m_pending.clear();
+    m_pending_count = 0;
+    return true;
+}
+
+
+//####################################################################################
+//##    History
+//####################################################################################
+// Returns false if there was nothing to undo
+bool DrUndoStack::undo() {
+    assert(m_recording == false && "Can't undo while recording a transaction!");
+    if (canUndo() == false) return false;
+    --m_applied;
+    applyTransaction(m_transactions[m_applied], false);
+    return true;
+}
+
+// Returns false if there was nothing to redo
+bool DrUndoStack::redo() {
+    assert(m_recording == false && "Can't redo while recording a transaction!");
+    if (canRedo() == false) return false;
+    applyTransaction(m_transactions[m_applied], true);
+    ++m_applied;
+    return true;
+}
+
+void DrUndoStack::clear() {
+    m_transactions.clear();
+    m_applied = 0;
+}
+
+// Bytes of memory held by history
+size_t DrUndoStack::memoryUsage() const {
+    return m_arena.capacity() + m_pending.capacity() + m_snapshots.capacity() +
+           m_touched.capacity() * sizeof(DrUndoSnapshot) + m_change_offsets.capacity() * sizeof(size_t) +
+           m_transactions.size() * sizeof(DrUndoTransaction);
+}
+
+// Writes old values (undo, in reverse order) or new values (redo, in recorded order) of a transaction
+void DrUndoStack::applyTransaction(const DrUndoTransaction& transaction, bool use_new) {
+    m_change_offsets.clear();
+    size_t at = transaction.start;
+    for (std::uint32_t i = 0; i < transaction.change_count; ++i) {
+        DrUndoChange change;
+        memcpy(&change, &m_arena[at], sizeof(DrUndoChange));
+        m_change_offsets.push_back(at);
+        at += sizeof(DrUndoChange) + change.size * 2;
+    }
+
+    for (size_t i = 0; i < m_change_offsets.size(); ++i) {
+        size_t change_at = m_change_offsets[use_new ? i : (m_change_offsets.size() - 1 - i)];
+        DrUndoChange change;
+        memcpy(&change, &m_arena[change_at], sizeof(DrUndoChange));
+        if (m_ecs->isAlive(change.entity) == false) continue;
+        if (m_ecs->getEntityType(change.entity).test(change.component_id) == false) continue;
+        char* component = static_cast<char*>(m_ecs->getData(static_cast<ComponentID>(change.component_id), change.entity));
+        const char* value = &m_arena[change_at + sizeof(DrUndoChange) + (use_new ? change.size : 0)];
+        memcpy(component + change.offset, value, change.size);
+    }
+}
+
+// Returns offset of 'bytes' of contiguous space in arena, dropping oldest transactions that are in the way
+size_t DrUndoStack::allocate(size_t bytes) {
+    if (m_transactions.empty()) return 0;
+    size_t head = m_transactions.back().start + m_transactions.back().bytes;
+
+    // Not enough room before end of arena, wrap around. Transactions after old head are the oldest, drop them first
+    if (head + bytes > m_arena.size()) {
+        while (m_transactions.empty() == false && m_transactions.front().start >= head) {
+            m_transactions.pop_front();
+            --m_applied;
+        }
+        head = 0;
+    }
+
+    // Drop oldest transactions overlapping new space
+    while (m_transactions.empty() == false &&
+           m_transactions.front().start < head + bytes &&
+           m_transactions.front().start + m_transactions.front().bytes > head) {
+        m_transactions.pop_front();
+        --m_applied;
+    }
+    return head;
+}
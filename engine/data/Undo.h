@@ -0,0 +1,113 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_DATA_UNDO_H
+#define DR_DATA_UNDO_H
+
+// Includes
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "engine/app/core/Reflect.h"
+#include "engine/data/Constants.h"
+#include "engine/ecs/Coordinator.h"
+
+// Local Defines
+#define UNDO_ARENA_SIZE         (4 * 1024 * 1024)                               // Default byte size of undo history ring buffer
+
+
+//####################################################################################
+//##    DrUndoStack
+//##        Undo / redo history of Component member values, stored as (Entity, Component, member offset, old bytes, new bytes)
+//##
+//##        Usage:
+//##            undo.begin();
+//##            undo.setMember<Transform2D>(entity, "position", new_position);     // Change one member through history
+//##            undo.touch(entity, component_id);                                   // Or snapshot Component before editing in place,
+//##            ...edit Component...                                                //      changed members are found with reflection on commit
+//##            undo.commit();
+//##
+//##        - History lives in a fixed size ring buffer, the oldest transactions are dropped when it is full
+//##        - undo() / redo() cost is proportional to the number of bytes changed by the transaction
+//##        - Only member values are recorded (not Entity / Component creation or removal), changes to Entities that
+//##          are no longer alive (or no longer have the Component) are skipped
+//##        - Recorded members must be trivially copyable
+//############################
+class DrUndoStack
+{
+public:
+    // Constructor
+    DrUndoStack(DrCoordinator* ecs, size_t arena_size = UNDO_ARENA_SIZE);
+
+private:
+    // Local Structs
+    struct DrUndoTransaction {
+        size_t                  start;                                              // Byte offset of first change in arena
+        size_t                  bytes;                                              // Byte size of all changes
+        std::uint32_t           change_count;                                       // Number of changes
+    };
+    struct DrUndoSnapshot {
+        EntityID                entity;
+        ComponentID             component_id;
+        size_t                  offset;                                             // Byte offset of Component copy in 'm_snapshots'
+    };
+
+    // #################### VARIABLES ####################
+    DrCoordinator*                  m_ecs;                                          // Entity Component System edits are applied to
+    std::vector<char>               m_arena;                                        // Ring buffer holding changes of all transactions
+    std::deque<DrUndoTransaction>   m_transactions      { };                        // Transactions in history, oldest first
+    size_t                          m_applied           { 0 };                      // Transactions that can be undone, the rest can be redone
+
+    bool                            m_recording         { false };                  // True between begin() and commit()
+    std::vector<char>               m_pending           { };                        // Changes of transaction being recorded
+    std::uint32_t                   m_pending_count     { 0 };                      // Number of changes in 'm_pending'
+    std::vector<DrUndoSnapshot>     m_touched           { };                        // Components to diff on commit
+    std::vector<char>               m_snapshots         { };                        // Copies of touched Components
+    std::vector<size_t>             m_change_offsets    { };                        // Scratch space for undo()
+
+public:
+    // #################### FUNCTIONS ####################
+    // Recording
+    void        begin();
+    void        touch(EntityID entity, ComponentID component_id);                   // Snapshot Component before editing it in place
+    void        recordChange(EntityID entity, ComponentID component_id, std::uint32_t offset, std::uint32_t size,
+                             const void* old_value, const void* new_value);         // Adds change to transaction (does not apply it)
+    bool        commit();                                                           // Adds transaction to history, returns false if nothing changed
+
+    // Changes a reflected member variable and records it
+    template<typename T, typename MemberType>
+    void setMember(EntityID entity, const std::string& member_name, const MemberType& value) {
+        static_assert(std::is_trivially_copyable<MemberType>::value, "Undo history can only record trivially copyable members!");
+        TypeData& member = MemberData<T>(member_name);
+        MemberType& current = ClassMember<MemberType>(&m_ecs->getComponent<T>(entity), member);
+        recordChange(entity, m_ecs->getComponentID<T>(), static_cast<std::uint32_t>(member.offset), sizeof(MemberType), &current, &value);
+        current = value;
+    }
+
+    // History
+    bool        undo();                                                             // Returns false if there was nothing to undo
+    bool        redo();                                                             // Returns false if there was nothing to redo
+    void        clear();
+    bool        canUndo() const         { return m_applied > 0; }
+    bool        canRedo() const         { return m_applied < m_transactions.size(); }
+    size_t      transactionCount() const { return m_transactions.size(); }
+    size_t      memoryUsage() const;                                                // Bytes of memory held by history
+
+private:
+    void        appendChange(EntityID entity, ComponentID component_id, std::uint32_t offset, std::uint32_t size,
+                             const void* old_value, const void* new_value);
+    void        applyTransaction(const DrUndoTransaction& transaction, bool use_new);
+    size_t      allocate(size_t bytes);                                             // Makes room in arena, dropping oldest transactions
+};
+
+
+#endif  // DR_DATA_UNDO_H
@@ -7,6 +7,7 @@
 // @source      https://github.com/scidian/eyedrop
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
+#include "engine/data/Serialize.h"
 #include "engine/ecs/Coordinator.h"
 #include "Scene.h"
 
@@ -22,4 +23,16 @@ IScene::IScene() {
 
 IScene::~IScene() {
     delete m_ecs;
-}
\ No newline at end of file
+}
+
+
+//####################################################################################
+//##    Saving / Loading
+//####################################################################################
+bool IScene::saveToFile(const std::string& file_path) {
+    return SaveScene(m_ecs, file_path);
+}
+
+bool IScene::loadFromFile(const std::string& file_path) {
+    return LoadScene(m_ecs, file_path);
+}
@@ -10,6 +10,9 @@
 #ifndef DR_SCENE_H
 #define DR_SCENE_H
 
+// Includes
+#include <string>
+
 // Forward Declarations
 class DrCoordinator;
 
@@ -33,6 +36,8 @@ private:
 
     // #################### FUNCTIONS TO BE EXPOSED TO API ####################
 public:
+    bool                    saveToFile(const std::string& file_path);               // Writes Entities / Components to binary scene file
+    bool                    loadFromFile(const std::string& file_path);             // Adds Entities / Components from binary scene file
 
 
     // #################### INTERNAL FUNCTIONS ####################
@@ -0,0 +1,410 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_ARCHETYPE_STORAGE_H
+#define DR_ECS_ARCHETYPE_STORAGE_H
+
+// Includes
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "engine/data/Constants.h"
+#include "ComponentInfo.h"
+#include "PagedArray.h"
+#include "Snapshot.h"
+
+// Local Defines
+#define ARCHETYPE_CHUNK_SIZE    (16 * 1024)                                     // Target byte size of one Archetype chunk
+
+
+//####################################################################################
+//##    DrArchetypeTable
+//##        Holds all Entities that share one Archetype, stored in fixed size SoA chunks:
+//##            [ EntityID x capacity ][ Component A x capacity ][ Component B x capacity ] ...
+//##        Rows are kept packed, removal swaps the last row into the hole
+//############################
+class DrArchetypeTable
+{
+	// #################### VARIABLES ####################
+private:
+	Archetype								m_archetype			{ };			// Components stored in this table
+	std::vector<ComponentID>				m_components		{ };			// Component IDs stored in this table
+	std::array<ArrayIndex, MAX_COMPONENTS>	m_offsets			{ };			// Byte offset of each Component array within a chunk, INDEX_NONE if not stored
+	std::vector<std::unique_ptr<std::max_align_t[]>>	m_chunks	{ };			// Chunk memory, aligned for any Component (see registerComponent())
+	const DrComponentInfo*					m_infos				{ nullptr };	// Component infos, indexed by ComponentID
+	ArrayIndex								m_chunk_capacity	{ 0 };			// Entities per chunk
+	ArrayIndex								m_chunk_bytes		{ 0 };			// Actual byte size of each chunk
+	ArrayIndex								m_size				{ 0 };			// Number of Entities in table
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Constructor, computes chunk layout for Archetype
+	DrArchetypeTable(Archetype archetype, const DrComponentInfo* infos) : m_archetype(archetype), m_infos(infos) {
+		m_offsets.fill(INDEX_NONE);
+		size_t row_bytes = sizeof(EntityID);
+		for (ComponentID id = 0; id < MAX_COMPONENTS; ++id) {
+			if (m_archetype.test(id)) {
+				m_components.push_back(id);
+				row_bytes += m_infos[id].size;
+			}
+		}
+
+		// Fit as many rows as possible into ARCHETYPE_CHUNK_SIZE, allowing for alignment padding
+		m_chunk_capacity = (ARCHETYPE_CHUNK_SIZE / row_bytes > 0) ? (ARCHETYPE_CHUNK_SIZE / row_bytes) : 1;
+		while (layout(m_chunk_capacity) > ARCHETYPE_CHUNK_SIZE && m_chunk_capacity > 1) {
+			--m_chunk_capacity;
+		}
+		m_chunk_bytes = layout(m_chunk_capacity);
+	}
+
+	// Destructor, destroys all living Components
+	~DrArchetypeTable() {
+		for (ArrayIndex row = 0; row < m_size; ++row) {
+			for (auto id : m_components) DestroyComponent(m_infos[id], componentAt(row, id));
+		}
+	}
+
+	// Table Info
+	const Archetype&				archetype() const						{ return m_archetype; }
+	const std::vector<ComponentID>&	components() const						{ return m_components; }
+	bool							hasComponent(ComponentID id) const		{ return m_offsets[id] != INDEX_NONE; }
+	ArrayIndex						size() const							{ return m_size; }
+
+	// Chunk Access
+	ArrayIndex		chunkCapacity() const									{ return m_chunk_capacity; }
+	ArrayIndex		chunkCount() const										{ return (m_size + m_chunk_capacity - 1) / m_chunk_capacity; }
+	ArrayIndex		chunkSize(ArrayIndex chunk) const {
+		ArrayIndex start = chunk * m_chunk_capacity;
+		return ((m_size - start) < m_chunk_capacity) ? (m_size - start) : m_chunk_capacity;
+	}
+	EntityID*		entities(ArrayIndex chunk)								{ return reinterpret_cast<EntityID*>(m_chunks[chunk].get()); }
+	void*			componentArray(ArrayIndex chunk, ComponentID id) {
+		assert(hasComponent(id) && "Component not stored in this Archetype!");
+		return reinterpret_cast<char*>(m_chunks[chunk].get()) + m_offsets[id];
+	}
+
+	// Row Access
+	EntityID		entityAt(ArrayIndex row)								{ return entities(row / m_chunk_capacity)[row % m_chunk_capacity]; }
+	void*			componentAt(ArrayIndex row, ComponentID id) {
+		return static_cast<char*>(componentArray(row / m_chunk_capacity, id)) + ((row % m_chunk_capacity) * m_infos[id].size);
+	}
+
+	// Adds a row for Entity at end of table, Components are left uninitialized for caller to construct
+	ArrayIndex pushEntity(EntityID entity) {
+		ArrayIndex row = m_size;
+		ArrayIndex chunk = row / m_chunk_capacity;
+		if (chunk >= m_chunks.size()) {
+			m_chunks.push_back(std::unique_ptr<std::max_align_t[]>(new std::max_align_t[(m_chunk_bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]));
+		}
+		entities(chunk)[row % m_chunk_capacity] = entity;
+		++m_size;
+		return row;
+	}
+
+	// Removes row by moving last row into its place, returns Entity that was moved into 'row' (KEY_NONE if none)
+	//		If 'destroy_components' is false, caller has already moved / destroyed Components of 'row'
+	EntityID removeRow(ArrayIndex row, bool destroy_components) {
+		assert(row < m_size && "Removing row out of range!");
+		if (destroy_components) {
+			for (auto id : m_components) DestroyComponent(m_infos[id], componentAt(row, id));
+		}
+
+		EntityID moved_entity = KEY_NONE;
+		ArrayIndex last = m_size - 1;
+		if (row != last) {
+			for (auto id : m_components) MoveComponent(m_infos[id], componentAt(row, id), componentAt(last, id));
+			moved_entity = entityAt(last);
+			entities(row / m_chunk_capacity)[row % m_chunk_capacity] = moved_entity;
+		}
+		--m_size;
+
+		// Release empty chunks, keeping one spare to avoid thrashing
+		while (m_chunks.size() > chunkCount() + 1) {
+			m_chunks.pop_back();
+		}
+		return moved_entity;
+	}
+
+	// Destroys all rows, keeps one chunk allocated
+	void clear() {
+		for (ArrayIndex row = 0; row < m_size; ++row) {
+			for (auto id : m_components) DestroyComponent(m_infos[id], componentAt(row, id));
+		}
+		m_size = 0;
+		while (m_chunks.size() > 1) m_chunks.pop_back();
+	}
+
+	// Copies rows into 'snapshot', one block per chunk for each Component
+	void saveSnapshot(DrEcsSnapshot::DrTableSnapshot& snapshot) {
+		snapshot.archetype = m_archetype;
+		snapshot.entities.resize(m_size);
+		snapshot.columns.resize(m_components.size());
+		for (size_t c = 0; c < m_components.size(); ++c) {
+			snapshot.columns[c] = DrComponentBuffer(m_infos[m_components[c]]);
+			snapshot.columns[c].reserve(m_size);
+		}
+		for (ArrayIndex chunk = 0; chunk < chunkCount(); ++chunk) {
+			memcpy(&snapshot.entities[chunk * m_chunk_capacity], entities(chunk), chunkSize(chunk) * sizeof(EntityID));
+			for (size_t c = 0; c < m_components.size(); ++c) {
+				snapshot.columns[c].append(componentArray(chunk, m_components[c]), chunkSize(chunk));
+			}
+		}
+	}
+
+	// Appends rows copied from 'snapshot' to end of table
+	void restoreSnapshot(const DrEcsSnapshot::DrTableSnapshot& snapshot) {
+		assert(snapshot.archetype == m_archetype && "Snapshot table does not match Archetype!");
+		ArrayIndex first = m_size;
+		ArrayIndex count = snapshot.entities.size();
+		m_size += count;
+		while (m_chunks.size() < chunkCount()) {
+			m_chunks.push_back(std::unique_ptr<std::max_align_t[]>(new std::max_align_t[(m_chunk_bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]));
+		}
+
+		// Copy in runs that stay within one chunk
+		for (ArrayIndex row = first; row < m_size; ) {
+			ArrayIndex chunk = row / m_chunk_capacity;
+			ArrayIndex start = row % m_chunk_capacity;
+			ArrayIndex run =   ((m_chunk_capacity - start) < (m_size - row)) ? (m_chunk_capacity - start) : (m_size - row);
+			memcpy(entities(chunk) + start, &snapshot.entities[row - first], run * sizeof(EntityID));
+			for (size_t c = 0; c < m_components.size(); ++c) {
+				const DrComponentInfo& info = m_infos[m_components[c]];
+				const char* src = static_cast<const char*>(snapshot.columns[c].data()) + ((row - first) * info.size);
+				char* dst = static_cast<char*>(componentArray(chunk, m_components[c])) + (start * info.size);
+				if (info.trivial) {
+					memcpy(dst, src, run * info.size);
+				} else {
+					for (ArrayIndex i = 0; i < run; ++i) info.copy(dst + (i * info.size), src + (i * info.size));
+				}
+			}
+			row += run;
+		}
+	}
+
+private:
+	// Calculates chunk byte offsets for 'capacity' rows, returns total bytes needed
+	ArrayIndex layout(ArrayIndex capacity) {
+		ArrayIndex offset = capacity * sizeof(EntityID);
+		for (auto id : m_components) {
+			ArrayIndex align = m_infos[id].align;
+			offset = ((offset + align - 1) / align) * align;
+			m_offsets[id] = offset;
+			offset += capacity * m_infos[id].size;
+		}
+		return offset;
+	}
+
+};
+
+
+//####################################################################################
+//##    DrArchetypeStorage
+//##        Stores Components grouped by Entity Archetype, used by DrCoordinator in ECS_STORAGE_ARCHETYPE mode
+//############################
+class DrArchetypeStorage
+{
+	// #################### LOCAL STRUCTS ####################
+	struct DrEntityLocation {
+		ArrayIndex		table	{ INDEX_NONE };									// Index of table in 'm_tables'
+		ArrayIndex		row		{ INDEX_NONE };									// Row of Entity within table
+	};
+
+	struct DrQueryCache {
+		std::vector<ArrayIndex>	tables			{ };							// Tables matching query Archetype
+		ArrayIndex				tables_checked	{ 0 };							// Number of tables already tested, tables are never removed
+	};
+
+	// #################### VARIABLES ####################
+private:
+	std::array<DrComponentInfo, MAX_COMPONENTS>			m_infos			{ };	// Component type info, indexed by ComponentID
+	std::vector<std::unique_ptr<DrArchetypeTable>>		m_tables		{ };	// One table per Archetype in use
+	std::unordered_map<Archetype, ArrayIndex>			m_table_lookup	{ };	// Archetype -> index in 'm_tables'
+	std::unordered_map<Archetype, DrQueryCache>			m_queries		{ };	// Cached query results
+	DrPagedLookup<DrEntityLocation>						m_locations		{ DrEntityLocation() };	// Location of each Entity, indexed by Entity index
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Stores type info of a Component so chunks can construct / move / destroy it
+	template<typename T>
+	void registerComponent(ComponentID id) {
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Component alignment too large for archetype chunks!");
+		m_infos[id] = ComponentInfo<T>();
+	}
+
+	// Places new Entity in the empty Archetype table
+	void entityCreated(EntityID entity) {
+		DrEntityLocation location;
+		location.table = getTableIndex(Archetype());
+		location.row =   m_tables[location.table]->pushEntity(entity);
+		m_locations.insert(GetEntityIndex(entity), location);
+	}
+
+	// Destroys all Components of Entity, removes Entity from its table
+	void entityDestroyed(EntityID entity) {
+		DrEntityLocation location = m_locations.get(GetEntityIndex(entity));
+		assert(location.table != INDEX_NONE && "Destroying entity not in storage!");
+		EntityID moved = m_tables[location.table]->removeRow(location.row, true);
+		if (moved != KEY_NONE) m_locations.at(GetEntityIndex(moved)).row = location.row;
+		m_locations.erase(GetEntityIndex(entity));
+	}
+
+	// Moves Entity to table with added Component, copies 'component' into place
+	void addComponent(EntityID entity, ComponentID id, const void* component) {
+		Archetype archetype = m_tables[m_locations.at(GetEntityIndex(entity)).table]->archetype();
+		assert(archetype.test(id) == false && "Component added to same entity more than once!");
+		archetype.set(id, true);
+		moveEntity(entity, getTableIndex(archetype));
+		constructComponents(id, &entity, &component, 1);
+	}
+
+	// Moves Entity to table without Component, Component is destroyed
+	void removeComponent(EntityID entity, ComponentID id) {
+		Archetype archetype = m_tables[m_locations.at(GetEntityIndex(entity)).table]->archetype();
+		assert(archetype.test(id) && "Removing non-existent component!");
+		archetype.set(id, false);
+		moveEntity(entity, getTableIndex(archetype));
+	}
+
+	// Returns pointer to Component of Entity
+	void* getComponent(EntityID entity, ComponentID id) {
+		DrEntityLocation& location = m_locations.at(GetEntityIndex(entity));
+		return m_tables[location.table]->componentAt(location.row, id);
+	}
+
+	// Moves Entity straight to table of 'archetype' (one move for any number of added / removed Components)
+	//		Components not in 'archetype' are destroyed, Components new to Entity are left uninitialized,
+	//		caller must construct each of them with constructComponents()
+	void changeArchetype(EntityID entity, Archetype archetype) {
+		ArrayIndex table = getTableIndex(archetype);
+		if (table != m_locations.at(GetEntityIndex(entity)).table) moveEntity(entity, table);
+	}
+
+	// Copy constructs 'data[i]' into uninitialized Component slot of 'entities[i]' (see changeArchetype())
+	void constructComponents(ComponentID id, const EntityID* entities, const void* const* data, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			DrEntityLocation& location = m_locations.at(GetEntityIndex(entities[i]));
+			CopyComponent(m_infos[id], m_tables[location.table]->componentAt(location.row, id), data[i]);
+		}
+	}
+
+	// Copy constructs a contiguous array of 'count' Components into slots left uninitialized by changeArchetype(),
+	//		'entities[i]' gets Component i, Entities in consecutive rows of one chunk are filled with one memcpy
+	void constructComponentArray(ComponentID id, const EntityID* entities, const void* components, size_t count) {
+		const DrComponentInfo& info = m_infos[id];
+		const char* from = static_cast<const char*>(components);
+		for (size_t i = 0; i < count; ) {
+			const DrEntityLocation& location = m_locations.get(GetEntityIndex(entities[i]));
+			DrArchetypeTable* table = m_tables[location.table].get();
+			size_t run = 1;
+			if (info.trivial) {
+				ArrayIndex chunk_end = ((location.row / table->chunkCapacity()) + 1) * table->chunkCapacity();
+				while (i + run < count && location.row + run < chunk_end) {
+					const DrEntityLocation& next = m_locations.get(GetEntityIndex(entities[i + run]));
+					if (next.table != location.table || next.row != location.row + run) break;
+					++run;
+				}
+				memcpy(table->componentAt(location.row, id), from + (i * info.size), run * info.size);
+			} else {
+				info.copy(table->componentAt(location.row, id), from + (i * info.size));
+			}
+			i += run;
+		}
+	}
+
+	// Replaces existing Component of Entity with a copy of 'component'
+	void replaceComponent(EntityID entity, ComponentID id, const void* component) {
+		void* existing = getComponent(entity, id);
+		DestroyComponent(m_infos[id], existing);
+		CopyComponent(m_infos[id], existing, component);
+	}
+
+	// Returns indices of all tables whose Archetype contains 'archetype', cached per Archetype
+	const std::vector<ArrayIndex>& matchingTables(Archetype archetype) {
+		DrQueryCache& query = m_queries[archetype];
+		for (; query.tables_checked < m_tables.size(); ++query.tables_checked) {
+			if ((m_tables[query.tables_checked]->archetype() & archetype) == archetype) {
+				query.tables.push_back(query.tables_checked);
+			}
+		}
+		return query.tables;
+	}
+
+	// Table access
+	DrArchetypeTable* getTable(ArrayIndex index)								{ return m_tables[index].get(); }
+
+	// Copies every table into 'snapshot'
+	void saveSnapshot(DrEcsSnapshot& snapshot) {
+		snapshot.tables.resize(m_tables.size());
+		for (size_t i = 0; i < m_tables.size(); ++i) m_tables[i]->saveSnapshot(snapshot.tables[i]);
+	}
+
+	// Replaces contents of all tables with those in 'snapshot', tables are never removed so every table in
+	// 'snapshot' still exists (tables created since then are left empty)
+	void restoreSnapshot(const DrEcsSnapshot& snapshot) {
+		assert(snapshot.tables.size() <= m_tables.size() && "Snapshot was saved from a different Coordinator!");
+		m_locations.clear();
+		for (size_t i = 0; i < m_tables.size(); ++i) {
+			m_tables[i]->clear();
+			if (i >= snapshot.tables.size()) continue;
+			m_tables[i]->restoreSnapshot(snapshot.tables[i]);
+			const std::vector<EntityID>& entities = snapshot.tables[i].entities;
+			for (ArrayIndex row = 0; row < entities.size(); ++row) {
+				DrEntityLocation location;
+				location.table = static_cast<ArrayIndex>(i);
+				location.row =   row;
+				m_locations.insert(GetEntityIndex(entities[row]), location);
+			}
+		}
+	}
+
+private:
+	// Finds (or creates) table for Archetype
+	ArrayIndex getTableIndex(Archetype archetype) {
+		auto it = m_table_lookup.find(archetype);
+		if (it != m_table_lookup.end()) return it->second;
+
+		ArrayIndex index = m_tables.size();
+		m_tables.push_back(std::unique_ptr<DrArchetypeTable>(new DrArchetypeTable(archetype, m_infos.data())));
+		m_table_lookup.insert({archetype, index});
+		return index;
+	}
+
+	// Moves Entity and its shared Components into another table, Components not in new table are destroyed
+	void moveEntity(EntityID entity, ArrayIndex to_table) {
+		DrEntityLocation& location = m_locations.at(GetEntityIndex(entity));
+		DrArchetypeTable* src = m_tables[location.table].get();
+		DrArchetypeTable* dst = m_tables[to_table].get();
+
+		ArrayIndex new_row = dst->pushEntity(entity);
+		for (auto id : src->components()) {
+			if (dst->hasComponent(id)) {
+				MoveComponent(m_infos[id], dst->componentAt(new_row, id), src->componentAt(location.row, id));
+			} else {
+				DestroyComponent(m_infos[id], src->componentAt(location.row, id));
+			}
+		}
+
+		EntityID moved = src->removeRow(location.row, false);
+		if (moved != KEY_NONE) m_locations.at(GetEntityIndex(moved)).row = location.row;
+		location.table = to_table;
+		location.row =   new_row;
+	}
+
+};
+
+
+#endif	// DR_ECS_ARCHETYPE_STORAGE_H
@@ -0,0 +1,314 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_COMMAND_BUFFER_H
+#define DR_ECS_COMMAND_BUFFER_H
+
+// Includes
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "engine/data/Constants.h"
+#include "Coordinator.h"
+
+// Local Defines
+#define COMMAND_BUFFER_BLOCK_SIZE   (64 * 1024)                                 // Byte size of each block of recorded Component data
+#define ENTITY_DEFERRED_BIT         0x80000000u                                 // Marks an EntityID returned by DrCommandBuffer::createEntity() before flush()
+
+
+//####################################################################################
+//##    DrCommandBuffer
+//##        Records structural changes (create / destroy Entities, add / remove Components) during System updates,
+//##        and applies them to a DrCoordinator at a sync point with flush()
+//##
+//##        - Recording is thread safe, for heavy use give each thread its own buffer to avoid lock contention
+//##        - Entities from createEntity() are placeholders until flush(), they can be passed to other calls on this buffer,
+//##          placeholders carry the flush generation in their version bits and are invalid after the next flush() / clear()
+//##        - flush() applies, in order: creates, Component changes, destroys
+//##        - Commands on the same Entity / Component are folded into their net result, the last one recorded wins
+//##          (add then remove leaves the Entity without the Component, removing a Component the Entity won't have is ignored)
+//##        - ECS_STORAGE_SPARSE_SET: changes are batched by Component so each Component array is visited once per flush
+//##        - ECS_STORAGE_ARCHETYPE: each Entity moves to the table of its final Archetype once per flush
+//##        - Each Entity's Archetype / System membership is updated once per flush
+//##        - Memory (command lists and Component data blocks) is reused between flushes
+//############################
+class DrCommandBuffer
+{
+	// #################### LOCAL STRUCTS ####################
+	struct DrComponentCommand {
+		ComponentID				component;										// ComponentID to add / remove
+		EntityID				entity;											// Entity (may be deferred until flush)
+		void*					data;											// Recorded Component, nullptr for removes
+		void					(*destroy)(void*);								// Destroys recorded Component (adds only)
+		size_t					sequence;										// Recording order, keeps sort deterministic
+	};
+
+	struct DrComponentChange {
+		ComponentID				component;
+		EntityID				entity;
+		const void*				data;											// Component to copy in, nullptr if Component is removed
+		bool					replace;										// Entity already has Component, 'data' replaces it
+	};
+
+	struct DrArchetypeChange {
+		EntityID				entity;
+		Archetype				added;
+		Archetype				removed;
+	};
+
+	// #################### VARIABLES ####################
+private:
+	DrCoordinator*									m_ecs				{ nullptr };	// ECS World commands are applied to
+	std::mutex										m_mutex				{ };			// Guards recording from multiple threads
+
+	EntityID										m_generation		{ 0 };			// Flush generation, stamped into version bits of deferred Entities
+	size_t											m_create_count		{ 0 };			// Number of deferred Entities
+	std::vector<EntityID>							m_created			{ };			// Deferred index -> real EntityID, filled during flush()
+	std::vector<EntityID>							m_destroys			{ };			// Entities to destroy
+	std::vector<DrComponentCommand>					m_commands			{ };			// Components to add / remove, in recording order
+
+	std::vector<std::unique_ptr<std::max_align_t[]>>	m_blocks		{ };			// Storage for recorded Component data
+	size_t											m_block				{ 0 };			// Current block in 'm_blocks'
+	size_t											m_block_offset		{ 0 };			// Byte offset into current block
+
+	std::vector<DrComponentChange>					m_component_changes	{ };			// Net Component changes of current flush, sorted by Entity
+	std::vector<DrArchetypeChange>					m_changes			{ };			// Per Entity Archetype changes of current flush
+	std::vector<EntityID>							m_run_entities		{ };			// Scratch run of Entities for one Component
+	std::vector<const void*>						m_run_data			{ };			// Scratch run of Component data for one Component
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Constructor / Destructor
+	explicit DrCommandBuffer(DrCoordinator* ecs) : m_ecs(ecs) { }
+	~DrCommandBuffer() {
+		clear();
+	}
+	DrCommandBuffer(const DrCommandBuffer&) = delete;
+	DrCommandBuffer& operator=(const DrCommandBuffer&) = delete;
+
+
+	// #################### Recording ####################
+	// Returns a placeholder EntityID, a real Entity is created during flush()
+	EntityID createEntity() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		assert(m_create_count < ENTITY_INDEX_MASK && "Too many deferred entities in command buffer!");
+		return MakeEntityID(static_cast<EntityID>(m_create_count++), m_generation) | ENTITY_DEFERRED_BIT;
+	}
+
+	// Entity is destroyed during flush()
+	void destroyEntity(EntityID entity) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_destroys.push_back(entity);
+	}
+
+	// Copies 'component', it is added to Entity during flush()
+	template<typename T>
+	void addComponent(EntityID entity, T component) {
+		ComponentID component_id = m_ecs->getComponentID<T>();
+		const DrComponentInfo& info = m_ecs->getComponentInfo(component_id);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		void* data = allocate(info.size, info.align);
+		new (data) T(std::move(component));
+		m_commands.push_back({ component_id, entity, data, info.destroy, m_commands.size() });
+	}
+
+	// Component of Type T is removed from Entity during flush()
+	template<typename T>
+	void removeComponent(EntityID entity) {
+		ComponentID component_id = m_ecs->getComponentID<T>();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_commands.push_back({ component_id, entity, nullptr, nullptr, m_commands.size() });
+	}
+
+	// Returns true if there are no recorded commands
+	bool empty() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return (m_create_count == 0 && m_destroys.empty() && m_commands.empty());
+	}
+
+
+	// #################### Playback ####################
+	// Applies all recorded commands to the Coordinator, call from a sync point (no Systems running)
+	void flush() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// ----- Creates
+		m_created.resize(m_create_count);
+		for (size_t i = 0; i < m_create_count; ++i) {
+			m_created[i] = m_ecs->createEntity();
+		}
+
+		// ----- Net Component changes, grouped by Entity
+		for (auto& command : m_commands) command.entity = resolve(command.entity);
+		std::sort(m_commands.begin(), m_commands.end(), [](const DrComponentCommand& a, const DrComponentCommand& b) {
+			if (a.entity != b.entity) return a.entity < b.entity;
+			if (a.component != b.component) return a.component < b.component;
+			return a.sequence < b.sequence;
+		});
+		foldCommands();
+
+		// ----- Apply Component changes
+		if (m_ecs->storageMode() == ECS_STORAGE_ARCHETYPE) {
+			applyByEntity();
+		} else {
+			applyByComponent();
+		}
+
+		// ----- Archetypes / Systems, once per Entity
+		for (auto& entity_change : m_changes) {
+			if ((entity_change.added | entity_change.removed).none()) continue;
+			m_ecs->applyArchetypeChange(entity_change.entity, entity_change.added, entity_change.removed);
+		}
+		m_changes.clear();
+		m_component_changes.clear();
+
+		// ----- Destroys
+		for (auto entity : m_destroys) {
+			m_ecs->destroyEntity(resolve(entity));
+		}
+
+		reset();
+	}
+
+	// Discards all recorded commands without applying them
+	void clear() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		reset();
+	}
+
+private:
+	// Converts a deferred EntityID into the Entity created during flush()
+	EntityID resolve(EntityID entity) {
+		if ((entity & ENTITY_DEFERRED_BIT) == 0) return entity;
+		assert(GetEntityVersion(entity) == (m_generation & ENTITY_VERSION_MASK) && "Deferred entity from an earlier flush!");
+		assert(GetEntityIndex(entity) < m_created.size() && "Deferred entity from another command buffer!");
+		return m_created[GetEntityIndex(entity)];
+	}
+
+	// Reduces sorted commands to one change per Entity / Component (last command recorded wins), fills
+	// 'm_component_changes' (sorted by Entity) and 'm_changes' (one entry per Entity with Component changes)
+	void foldCommands() {
+		for (size_t start = 0; start < m_commands.size(); ) {
+			EntityID entity = m_commands[start].entity;
+			Archetype archetype = m_ecs->getEntityType(entity);
+			DrArchetypeChange entity_change { entity, Archetype(), Archetype() };
+			size_t first_change = m_component_changes.size();
+
+			for (; start < m_commands.size() && m_commands[start].entity == entity; ) {
+				ComponentID component_id = m_commands[start].component;
+				const void* data = nullptr;
+				for (; start < m_commands.size() && m_commands[start].entity == entity && m_commands[start].component == component_id; ++start) {
+					data = m_commands[start].data;
+				}
+
+				bool had = archetype.test(component_id);
+				if (data == nullptr) {
+					if (had == false) continue;
+					entity_change.removed.set(component_id, true);
+				} else if (had == false) {
+					entity_change.added.set(component_id, true);
+				}
+				m_component_changes.push_back({ component_id, entity, data, (data != nullptr && had) });
+			}
+			if (m_component_changes.size() > first_change) m_changes.push_back(entity_change);
+		}
+	}
+
+	// Archetype storage, moves each Entity to the table of its final Archetype once, then copies in its new Components
+	void applyByEntity() {
+		size_t next = 0;
+		for (auto& entity_change : m_changes) {
+			EntityID entity = entity_change.entity;
+			Archetype archetype = (m_ecs->getEntityType(entity) & ~entity_change.removed) | entity_change.added;
+			m_ecs->moveComponentData(entity, archetype);
+			for (; next < m_component_changes.size() && m_component_changes[next].entity == entity; ++next) {
+				DrComponentChange& component_change = m_component_changes[next];
+				if (component_change.data == nullptr) continue;
+				if (component_change.replace) {
+					m_ecs->replaceComponentData(component_change.component, entity, component_change.data);
+				} else {
+					m_ecs->constructComponentData(component_change.component, &entity, &component_change.data, 1);
+				}
+			}
+		}
+	}
+
+	// Sparse set storage, removes / adds one Component type at a time so each Component array is visited once
+	void applyByComponent() {
+		std::sort(m_component_changes.begin(), m_component_changes.end(), [](const DrComponentChange& a, const DrComponentChange& b) {
+			if (a.component != b.component) return a.component < b.component;
+			return a.entity < b.entity;
+		});
+		for (size_t start = 0; start < m_component_changes.size(); ) {
+			ComponentID component_id = m_component_changes[start].component;
+			size_t end = start;
+			while (end < m_component_changes.size() && m_component_changes[end].component == component_id) ++end;
+
+			m_run_entities.clear();
+			for (size_t i = start; i < end; ++i) {
+				if (m_component_changes[i].data == nullptr) m_run_entities.push_back(m_component_changes[i].entity);
+			}
+			if (m_run_entities.empty() == false) m_ecs->eraseComponentData(component_id, m_run_entities.data(), m_run_entities.size());
+
+			m_run_entities.clear();
+			m_run_data.clear();
+			for (size_t i = start; i < end; ++i) {
+				DrComponentChange& component_change = m_component_changes[i];
+				if (component_change.data == nullptr) continue;
+				if (component_change.replace) {
+					m_ecs->replaceComponentData(component_id, component_change.entity, component_change.data);
+				} else {
+					m_run_entities.push_back(component_change.entity);
+					m_run_data.push_back(component_change.data);
+				}
+			}
+			if (m_run_entities.empty() == false) m_ecs->insertComponentData(component_id, m_run_entities.data(), m_run_data.data(), m_run_entities.size());
+			start = end;
+		}
+	}
+
+	// Bump allocates recorded Component data, blocks are kept for reuse
+	void* allocate(size_t size, size_t align) {
+		assert(size <= COMMAND_BUFFER_BLOCK_SIZE && "Component too large for command buffer!");
+		assert(align <= alignof(std::max_align_t) && "Component alignment too large for command buffer!");
+		m_block_offset = ((m_block_offset + align - 1) / align) * align;
+		if (m_blocks.empty() || m_block_offset + size > COMMAND_BUFFER_BLOCK_SIZE) {
+			if (m_blocks.empty() == false) ++m_block;
+			m_block_offset = 0;
+		}
+		if (m_block >= m_blocks.size()) {
+			m_blocks.push_back(std::unique_ptr<std::max_align_t[]>(new std::max_align_t[COMMAND_BUFFER_BLOCK_SIZE / sizeof(std::max_align_t)]));
+		}
+		void* data = reinterpret_cast<char*>(m_blocks[m_block].get()) + m_block_offset;
+		m_block_offset += size;
+		return data;
+	}
+
+	// Destroys recorded Component data, empties command lists (keeps capacity)
+	void reset() {
+		for (auto& command : m_commands) {
+			if (command.data) command.destroy(command.data);
+		}
+		m_commands.clear();
+		m_destroys.clear();
+		m_created.clear();
+		m_create_count = 0;
+		++m_generation;
+		m_block = 0;
+		m_block_offset = 0;
+	}
+
+};
+
+
+#endif	// DR_ECS_COMMAND_BUFFER_H
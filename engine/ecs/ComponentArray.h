@@ -11,8 +11,14 @@
 #define DR_ECS_COMPONENT_ARRAY_H
 
 // Includes
-#include <unordered_map>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "engine/data/Constants.h"
+#include "ComponentInfo.h"
+#include "PagedArray.h"
+#include "Snapshot.h"
 
 //####################################################################################
 //##    IComponentArray
@@ -24,38 +30,60 @@ public:
 	virtual ~IComponentArray() = default;
 	virtual void entityDestroyed(EntityID entity) = 0;
 	virtual void* getDataPointer(EntityID entity) = 0;
+	virtual void insertDataPointer(EntityID entity, const void* data) = 0;
+	virtual void removeData(EntityID entity) = 0;
+	virtual ArrayIndex size() const = 0;
+	virtual EntityID entityAt(ArrayIndex packed_index) const = 0;
+	virtual void* dataPointerAt(ArrayIndex packed_index) = 0;
+	virtual ArrayIndex pageCount() const = 0;
+	virtual ArrayIndex pageSize(ArrayIndex page) const = 0;
+	virtual void* pageDataPointer(ArrayIndex page) = 0;
+	virtual bool trivial() const = 0;
+	virtual void copyData(void* destination) const = 0;
+	virtual void saveSnapshot(std::vector<EntityID>& entities, DrComponentBuffer& components) const = 0;
+	virtual void restoreSnapshot(const EntityID* entities, const void* components, ArrayIndex count) = 0;
 };
 
 
 //####################################################################################
 //##    ComponentArray
-//##
+//##		Sparse set, Components are kept packed in 'm_component_array'
+//##		'm_entity_to_index' is the sparse lookup (Entity index -> packed index)
+//##		'm_index_to_entity' is the dense list of Entities, kept in step with the packed Components
+//##		Storage is paged (see PagedArray.h), memory grows with the number of Components rather than MAX_ENTITIES
+//##		Trivially copyable Components are moved with memcpy and can be copied out in bulk, one memcpy per page
 //############################
 template<typename T>
 class DrComponentArray : public IComponentArray
 {
 	// #################### VARIABLES ####################
 private:
-	std::array<T, MAX_ENTITIES> 				m_component_array	{ };
-	std::unordered_map<EntityID, ArrayIndex> 	m_entity_to_index	{ };
-	std::unordered_map<ArrayIndex, EntityID> 	m_index_to_entity	{ };
-	ArrayIndex   								m_size				{ 0 };
+	DrPagedVector<T>		 					m_component_array	{ };
+	DrPagedLookup<ArrayIndex> 					m_entity_to_index	{ INDEX_NONE };
+	DrPagedVector<EntityID> 					m_index_to_entity	{ };
 
 
 	// #################### INTERNAL FUNCTIONS ####################
 public:
 	// Called from coordinator when Entity is being removed from Entity Component System
 	void entityDestroyed(EntityID entity) override {
-		if (m_entity_to_index.find(entity) != m_entity_to_index.end()) {
+		if (hasData(entity)) {
 			removeData(entity);
 		}
 	}
 
+	// Returns true if Entity has a Component stored in this ComponentArray
+	bool hasData(EntityID entity) const {
+		EntityID index = GetEntityIndex(entity);
+		assert((index >= KEY_START && index <= MAX_ENTITIES) && "Entity out of range!");
+		ArrayIndex packed_index = m_entity_to_index.get(index);
+		return (packed_index != INDEX_NONE && m_index_to_entity[packed_index] == entity);
+	}
+
 	// Gets instance of a Component for Entity
 	T& getData(EntityID entity) {
-		//assert(m_entity_to_index.find(entity) != m_entity_to_index.end() && "Retrieving non-existent component!");
-		assert((entity >= KEY_START && entity < MAX_ENTITIES) && "Entity out of range!");
-		return m_component_array[m_entity_to_index[entity]];
+		assert(hasData(entity) && "Retrieving non-existent component!");
+		return m_component_array[m_entity_to_index.get(GetEntityIndex(entity))];
 	}
 
 	// Returns instance of a Component as void* for Entity
@@ -63,39 +91,91 @@ public:
 		return ((void*)(&getData(entity)));
 	}
 
+	// Adds a Component as void* (must point to a T) to the ComponentArray for an Entity
+	void insertDataPointer(EntityID entity, const void* data) override {
+		insertData(entity, *static_cast<const T*>(data));
+	}
+
 	// Adds a Component to the ComponentArray for an Entity
 	void insertData(EntityID entity, T component) {
-		assert(m_entity_to_index.find(entity) == m_entity_to_index.end() && "Component added to same entity more than once!");
+		assert(!hasData(entity) && "Component added to same entity more than once!");
 
 		// Put new entry at end
-		ArrayIndex new_index = m_size;
-		m_entity_to_index[entity] = new_index;
-		m_index_to_entity[new_index] = entity;
-		m_component_array[new_index] = component;
-		++m_size;
+		m_entity_to_index.insert(GetEntityIndex(entity), m_component_array.size());
+		m_index_to_entity.push_back(entity);
+		m_component_array.push_back(std::move(component));
 	}
 
 	// Removes Component for Entity
-	void removeData(EntityID entity) {
-		assert(m_entity_to_index.find(entity) != m_entity_to_index.end() && "Removing non-existent component!");
-
-		// Copy element at end into deleted element's place to maintain density
-		ArrayIndex index_of_removed_entity = m_entity_to_index[entity];
-		ArrayIndex index_of_last_element = m_size - 1;
-		m_component_array[index_of_removed_entity] = m_component_array[index_of_last_element];
-
-		// Update map to point to moved spot
-		EntityID entity_of_last_element = m_index_to_entity[index_of_last_element];
-		m_entity_to_index[entity_of_last_element] = index_of_removed_entity;
-		m_index_to_entity[index_of_removed_entity] = entity_of_last_element;
-
-		m_entity_to_index.erase(entity);
-		m_index_to_entity.erase(index_of_last_element);
-		--m_size;
+	void removeData(EntityID entity) override {
+		assert(hasData(entity) && "Removing non-existent component!");
+
+		// Move element at end into deleted element's place to maintain density
+		ArrayIndex index_of_removed_entity = m_entity_to_index.get(GetEntityIndex(entity));
+		ArrayIndex index_of_last_element = m_component_array.size() - 1;
+		if (index_of_removed_entity != index_of_last_element) {
+			moveElement(m_component_array[index_of_removed_entity], m_component_array[index_of_last_element], std::is_trivially_copyable<T>());
+
+			// Update lookups to point to moved spot
+			EntityID entity_of_last_element = m_index_to_entity[index_of_last_element];
+			m_entity_to_index.at(GetEntityIndex(entity_of_last_element)) = index_of_removed_entity;
+			m_index_to_entity[index_of_removed_entity] = entity_of_last_element;
+		}
+
+		m_entity_to_index.erase(GetEntityIndex(entity));
+		m_component_array.pop_back();
+		m_index_to_entity.pop_back();
+	}
+
+	// Packed access, for iterating all Components of this type linearly, one page at a time
+	ArrayIndex size() const override 				{ return m_component_array.size(); }
+	ArrayIndex pageCount() const override 			{ return m_component_array.pageCount(); }
+	ArrayIndex pageSize(ArrayIndex page) const override { return m_component_array.pageSize(page); }
+	T& at(ArrayIndex packed_index) 					{ return m_component_array[packed_index]; }
+	EntityID entityAt(ArrayIndex packed_index) const override { return m_index_to_entity[packed_index]; }
+	void* dataPointerAt(ArrayIndex packed_index) override { return &m_component_array[packed_index]; }
+	T* pageData(ArrayIndex page) 					{ return m_component_array.pageData(page); }
+	void* pageDataPointer(ArrayIndex page) override { return m_component_array.pageData(page); }
+
+	// Bulk access, trivially copyable Components only
+	bool trivial() const override 					{ return std::is_trivially_copyable<T>::value; }
+
+	// Copies all Components in packed order to 'destination' (must hold size() Components)
+	void copyData(void* destination) const override {
+		assert(trivial() && "Bulk copy requires trivially copyable Component!");
+		char* to = static_cast<char*>(destination);
+		for (ArrayIndex page = 0; page < m_component_array.pageCount(); ++page) {
+			size_t bytes = m_component_array.pageSize(page) * sizeof(T);
+			memcpy(to, m_component_array.pageData(page), bytes);
+			to += bytes;
+		}
 	}
 
+	// Copies packed Entities / Components into snapshot buffers
+	void saveSnapshot(std::vector<EntityID>& entities, DrComponentBuffer& components) const override {
+		entities.resize(m_index_to_entity.size());
+		m_index_to_entity.copyTo(entities.data());
+		components = DrComponentBuffer(ComponentInfo<T>());
+		components.reserve(m_component_array.size());
+		for (ArrayIndex page = 0; page < m_component_array.pageCount(); ++page) {
+			components.append(m_component_array.pageData(page), m_component_array.pageSize(page));
+		}
+	}
+
+	// Replaces all Components with 'count' packed Components from a snapshot, rebuilds Entity lookup
+	void restoreSnapshot(const EntityID* entities, const void* components, ArrayIndex count) override {
+		m_component_array.assign(static_cast<const T*>(components), count);
+		m_index_to_entity.assign(entities, count);
+		m_entity_to_index.clear();
+		for (ArrayIndex i = 0; i < count; ++i) m_entity_to_index.insert(GetEntityIndex(entities[i]), i);
+	}
+
+private:
+	// Assigns 'from' into 'to', memcpy for trivially copyable Components
+	static void moveElement(T& to, T& from, std::true_type)		{ memcpy(static_cast<void*>(&to), static_cast<const void*>(&from), sizeof(T)); }
+	static void moveElement(T& to, T& from, std::false_type)	{ to = std::move(from); }
+
 };
 
 
 #endif	// DR_ECS_COMPONENT_ARRAY
-
@@ -0,0 +1,64 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_COMPONENT_INFO_H
+#define DR_ECS_COMPONENT_INFO_H
+
+// Includes
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "engine/app/core/ReflectPod.h"
+
+
+//####################################################################################
+//##    DrComponentInfo
+//##        Type erased description of a Component, allows chunks to hold any Component type
+//############################
+struct DrComponentInfo {
+	size_t		size								{ 0 };					// sizeof(T)
+	size_t		align								{ 1 };					// alignof(T)
+	bool		trivial								{ false };				// std::is_trivially_copyable<T>, Component can be copied with memcpy
+	void		(*construct)(void* dst)				{ nullptr };			// Default constructs Component into uninitialized 'dst'
+	void		(*copy)(void* dst, const void* src)	{ nullptr };			// Copy constructs 'src' into uninitialized 'dst'
+	void		(*move)(void* dst, void* src)		{ nullptr };			// Move constructs 'src' into uninitialized 'dst', then destroys 'src'
+	void		(*destroy)(void* ptr)				{ nullptr };			// Calls destructor of Component at 'ptr'
+	const PodMemberData* members				{ nullptr };			// Compile time member table (REFLECT_POD), nullptr if T has none
+	int			member_count						{ 0 };					// Number of entries in 'members'
+};
+
+// Builds DrComponentInfo for Component Type T
+template<typename T>
+DrComponentInfo ComponentInfo() {
+	DrComponentInfo info { };
+		info.size =		sizeof(T);
+		info.align =	alignof(T);
+		info.trivial =	std::is_trivially_copyable<T>::value;
+		info.construct = [](void* dst) { new (dst) T(); };
+		info.copy =		[](void* dst, const void* src) { new (dst) T(*static_cast<const T*>(src)); };
+		info.move =		[](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); static_cast<T*>(src)->~T(); };
+		info.destroy =	[](void* ptr) { static_cast<T*>(ptr)->~T(); };
+		info.members =	PodReflection<T>::members(info.member_count);
+	return info;
+}
+
+// Copy / move / destroy helpers, trivially copyable Components use memcpy (and have nothing to destroy)
+inline void CopyComponent(const DrComponentInfo& info, void* dst, const void* src) {
+	if (info.trivial) memcpy(dst, src, info.size); else info.copy(dst, src);
+}
+inline void MoveComponent(const DrComponentInfo& info, void* dst, void* src) {
+	if (info.trivial) memcpy(dst, src, info.size); else info.move(dst, src);
+}
+inline void DestroyComponent(const DrComponentInfo& info, void* ptr) {
+	if (info.trivial == false) info.destroy(ptr);
+}
+
+
+#endif	// DR_ECS_COMPONENT_INFO_H
@@ -10,32 +10,54 @@
 #ifndef DR_ECS_COMPONENT_MANAGER_H
 #define DR_ECS_COMPONENT_MANAGER_H
 
+#include <array>
+#include <typeinfo>
+#include <vector>
 #include "engine/data/Constants.h"
 #include "ComponentArray.h"
+#include "Snapshot.h"
+#include "TypeIndex.h"
+
+// Local Defines
+#define COMPONENT_ID_NONE         255                                           // Value of TypeIndex lookup slots for unregistered Types
 
 
 //####################################################################################
 //##    DrComponentManager
 //##        Keeps track of Components within Coordinator (ECS World)
+//##        - 'm_type_component_ids' maps TypeIndex<T>() -> ComponentID, 'm_component_arrays' maps ComponentID -> array,
+//##          so typed access is two flat array lookups (no hashing, no shared_ptr refcounting)
 //############################
 class DrComponentManager
 {
 	// #################### VARIABLES ####################
 private:
-	std::unordered_map<HashID, ComponentID> 						m_component_ids			{ };
-	std::unordered_map<HashID, std::shared_ptr<IComponentArray>>	m_component_arrays		{ };
-	ComponentID 													m_next_component_id		{ 0 };
+	std::vector<ComponentID>							m_type_component_ids	{ };		// TypeIndex<T>() -> ComponentID, COMPONENT_ID_NONE if not registered
+	std::array<IComponentArray*, MAX_COMPONENTS>		m_component_arrays		{ };		// ComponentID -> ComponentArray (owned)
+	std::array<HashID, MAX_COMPONENTS>					m_component_hashes		{ };		// ComponentID -> typeid().hash_code()
+	ComponentID 										m_next_component_id		{ 0 };
 
 
 public:
+	// Constructor / Destructor
+	DrComponentManager() { }
+	~DrComponentManager() {
+		for (ComponentID i = 0; i < m_next_component_id; ++i) delete m_component_arrays[i];
+	}
+	DrComponentManager(const DrComponentManager&) = delete;
+	DrComponentManager& operator=(const DrComponentManager&) = delete;
+
 	// Registers a Component Type with Entity Component System, ex: registerComponent<Transform>();
 	template<typename T>
 	void registerComponent() {
-		HashID hash = typeid(T).hash_code();
-		assert(m_component_ids.find(hash) == m_component_ids.end() && "Registering component type more than once!");
-
-		m_component_ids.insert({hash, m_next_component_id});
-		m_component_arrays.insert({hash, std::make_shared<DrComponentArray<T>>()});
+		size_t type_index = TypeIndex<T>();
+		if (type_index >= m_type_component_ids.size()) m_type_component_ids.resize(type_index + 1, COMPONENT_ID_NONE);
+		assert(m_type_component_ids[type_index] == COMPONENT_ID_NONE && "Registering component type more than once!");
+		assert(m_next_component_id < MAX_COMPONENTS && "Too many component types registered!");
+
+		m_type_component_ids[type_index] =             m_next_component_id;
+		m_component_arrays[m_next_component_id] =      new DrComponentArray<T>();
+		m_component_hashes[m_next_component_id] =      typeid(T).hash_code();
 		++m_next_component_id;
 	}
 
@@ -59,46 +81,56 @@ public:
 
 	// Gets ComponentArray of Type T
 	template<typename T>
-	std::shared_ptr<DrComponentArray<T>> getComponentArray() {
-		HashID hash = typeid(T).hash_code();
-		assert(m_component_ids.find(hash) != m_component_ids.end() && "Component not registered before use!");
-		return std::static_pointer_cast<DrComponentArray<T>>(m_component_arrays[hash]);
+	DrComponentArray<T>* getComponentArray() {
+		return static_cast<DrComponentArray<T>*>(m_component_arrays[getComponentID<T>()]);
 	}
 
 	// For grabbing Component by type (for Object Inspector)
 	IComponentArray* getComponentArray(ComponentID component_id) {
-		for (auto& pair : m_component_ids) {
-			if (pair.second == component_id) {
-				return m_component_arrays[pair.first].get();
-			}
-		}
-		assert(false && "Component Array not found!");
+		assert(component_id < m_next_component_id && "Component Array not found!");
+		return m_component_arrays[component_id];
 	}
 
 	// Gets component id (bitset) of a Component with Type T
 	template<typename T>
 	ComponentID getComponentID() {
-		HashID hash = typeid(T).hash_code();
-		assert(m_component_ids.find(hash) != m_component_ids.end() && "Component not registered before use!");
-		return m_component_ids[hash];
+		size_t type_index = TypeIndex<T>();
+		assert(type_index < m_type_component_ids.size() && m_type_component_ids[type_index] != COMPONENT_ID_NONE && "Component not registered before use!");
+		return m_type_component_ids[type_index];
 	}
 
 	// Returns typeid().hash_code() of Component Type
 	HashID getComponentHashID(ComponentID component_id) {
-		for (auto& pair : m_component_ids) {
-			if (pair.second == component_id) {
-				HashID hash = pair.first;
-				return hash;
-			}
+		assert(component_id < m_next_component_id && "Component ID not found!");
+		return m_component_hashes[component_id];
+	}
+
+	// Number of registered Component types, ComponentIDs are 0 to componentCount() - 1
+	ComponentID componentCount() const {
+		return m_next_component_id;
+	}
+
+	// Copies every ComponentArray into 'snapshot'
+	void saveSnapshot(DrEcsSnapshot& snapshot) const {
+		snapshot.component_arrays.resize(m_next_component_id);
+		for (ComponentID i = 0; i < m_next_component_id; ++i) {
+			m_component_arrays[i]->saveSnapshot(snapshot.component_arrays[i].entities, snapshot.component_arrays[i].components);
+		}
+	}
+
+	// Replaces contents of every ComponentArray with those in 'snapshot'
+	void restoreSnapshot(const DrEcsSnapshot& snapshot) {
+		assert(snapshot.component_arrays.size() == m_next_component_id && "Snapshot was saved with different Components registered!");
+		for (ComponentID i = 0; i < m_next_component_id; ++i) {
+			const DrEcsSnapshot::DrComponentArraySnapshot& array = snapshot.component_arrays[i];
+			m_component_arrays[i]->restoreSnapshot(array.entities.data(), array.components.data(), array.entities.size());
 		}
-		assert(false && "Component ID not found!");
 	}
 
 	// Called from Coordinator.destroyEntity()
 	void entityDestroyed(EntityID entity) {
-		for (auto const& pair : m_component_arrays) {
-			auto const& component = pair.second;
-			component->entityDestroyed(entity);
+		for (ComponentID i = 0; i < m_next_component_id; ++i) {
+			m_component_arrays[i]->entityDestroyed(entity);
 		}
 	}
 
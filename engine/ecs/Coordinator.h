@@ -12,11 +12,20 @@
 
 // Includes
 #include "engine/data/Constants.h"
+#include "ArchetypeStorage.h"
 #include "ComponentManager.h"
 #include "EntityManager.h"
 #include "EventManager.h"
+#include "Query.h"
+#include "Snapshot.h"
 #include "SystemManager.h"
 
+// Component storage layout of a Coordinator
+enum Ecs_Storage {
+	ECS_STORAGE_SPARSE_SET,				// One packed DrComponentArray per Component type (default)
+	ECS_STORAGE_ARCHETYPE,				// Entities grouped by Archetype into SoA chunks, allows fast query<A, B, C>() iteration
+};
+
 
 //####################################################################################
 //##    DrCoordinator
@@ -30,16 +39,23 @@ private:
 	DrEntityManager*        m_entity_manager;
 	DrEventManager*         m_event_manager;
 	DrSystemManager*        m_system_manager;
+	DrArchetypeStorage*     m_archetype_storage		{ nullptr };		// Only used with ECS_STORAGE_ARCHETYPE
+	Ecs_Storage             m_storage_mode;
+	std::array<DrComponentInfo, MAX_COMPONENTS>	m_component_infos	{ };	// Type erased info of each registered Component, indexed by ComponentID
 
 public:
 	// Constructor / Destructor
-	DrCoordinator() {
+	DrCoordinator(Ecs_Storage storage_mode = ECS_STORAGE_SPARSE_SET) : m_storage_mode(storage_mode) {
 		m_component_manager = new DrComponentManager();
 		m_entity_manager =    new DrEntityManager();
 		m_event_manager =     new DrEventManager();
 		m_system_manager =    new DrSystemManager();
+		if (m_storage_mode == ECS_STORAGE_ARCHETYPE) {
+			m_archetype_storage = new DrArchetypeStorage();
+		}
 	}
     ~DrCoordinator() {
+        delete m_archetype_storage;
         delete m_component_manager;
         delete m_entity_manager;
         delete m_event_manager;
@@ -50,16 +66,39 @@ public:
 	// #################### Entity Methods ####################
 	// Adds new Entity to Entity Component System
 	EntityID createEntity() {
-		return m_entity_manager->createEntity();
+		EntityID entity = m_entity_manager->createEntity();
+		if (m_archetype_storage) m_archetype_storage->entityCreated(entity);
+		return entity;
 	}
 
 	// Mark Entity as removed from Entity Component System
 	void destroyEntity(EntityID entity) {
 		m_entity_manager->destroyEntity(entity);
-		m_component_manager->entityDestroyed(entity);
+		if (m_archetype_storage) {
+			m_archetype_storage->entityDestroyed(entity);
+		} else {
+			m_component_manager->entityDestroyed(entity);
+		}
 		m_system_manager->entityDestroyed(entity);
 	}
 
+	// Returns true if EntityID refers to a living Entity, false if it was destroyed (stale handle)
+	//		Slots are retired rather than letting their 11 bit version wrap, so stale handles stay stale
+	bool isAlive(EntityID entity) {
+		return m_entity_manager->isAlive(entity);
+	}
+
+	// Calls func(EntityID) for every living Entity
+	template<typename Func>
+	void eachEntity(Func func) {
+		m_entity_manager->eachEntity(func);
+	}
+
+	// Number of living Entities
+	EntityID entityCount() {
+		return m_entity_manager->livingCount();
+	}
+
 	// Returns a total bitset signature from Entity representing all Components Entity owns
 	Archetype getEntityType(EntityID entity) {
 		return m_entity_manager->getArchetype(entity);
@@ -71,38 +110,58 @@ public:
 	template<typename T>
 	void registerComponent() {
 		m_component_manager->registerComponent<T>();
+		m_component_infos[m_component_manager->getComponentID<T>()] = ComponentInfo<T>();
+		if (m_archetype_storage) m_archetype_storage->registerComponent<T>(m_component_manager->getComponentID<T>());
 	}
 
 	// Adds a Component of Type T to Entity with data from 'component'
 	template<typename T>
 	void addComponent(EntityID entity, T component) {
-		m_component_manager->addComponent<T>(entity, component);
+		assert(m_entity_manager->isAlive(entity) && "Stale or invalid entity!");
+		ComponentID component_id = m_component_manager->getComponentID<T>();
+		if (m_archetype_storage) {
+			m_archetype_storage->addComponent(entity, component_id, &component);
+		} else {
+			m_component_manager->addComponent<T>(entity, component);
+		}
 
 		auto archetype = m_entity_manager->getArchetype(entity);
-		archetype.set(m_component_manager->getComponentID<T>(), true);
+		archetype.set(component_id, true);
 		m_entity_manager->setArchetype(entity, archetype);
-		m_system_manager->entityArchetypeChanged(entity, archetype);
+		m_system_manager->entityArchetypeChanged(entity, archetype, component_id);
 	}
 
 	// Removes a Component of Type T from Entity
 	template<typename T>
 	void removeComponent(EntityID entity) {
-		m_component_manager->removeComponent<T>(entity);
+		assert(m_entity_manager->isAlive(entity) && "Stale or invalid entity!");
+		ComponentID component_id = m_component_manager->getComponentID<T>();
+		if (m_archetype_storage) {
+			m_archetype_storage->removeComponent(entity, component_id);
+		} else {
+			m_component_manager->removeComponent<T>(entity);
+		}
 
 		auto archetype = m_entity_manager->getArchetype(entity);
-		archetype.set(m_component_manager->getComponentID<T>(), false);
+		archetype.set(component_id, false);
 		m_entity_manager->setArchetype(entity, archetype);
-		m_system_manager->entityArchetypeChanged(entity, archetype);
+		m_system_manager->entityArchetypeChanged(entity, archetype, component_id);
 	}
 
 	// Returns Component of Entity with Type T
 	template<typename T>
 	T& getComponent(EntityID entity) {
+		assert(m_entity_manager->isAlive(entity) && "Stale or invalid entity!");
+		if (m_archetype_storage) {
+			return *static_cast<T*>(m_archetype_storage->getComponent(entity, m_component_manager->getComponentID<T>()));
+		}
 		return m_component_manager->getComponent<T>(entity);
 	}
 
 	// Returns void* reference to Component of Entity from a Component ID (don't need to know Type)
 	void* getData(ComponentID component_id, EntityID entity) {
+		assert(m_entity_manager->isAlive(entity) && "Stale or invalid entity!");
+		if (m_archetype_storage) return m_archetype_storage->getComponent(entity, component_id);
 		IComponentArray* component_array = m_component_manager->getComponentArray(component_id);
 		void* component_instance = component_array->getDataPointer(entity);
 		return component_instance;
@@ -119,6 +178,170 @@ public:
 		return m_component_manager->getComponentHashID(component_id);
 	}
 
+	// Returns type erased info (size, copy, construct, etc) of a registered Component
+	const DrComponentInfo& getComponentInfo(ComponentID component_id) {
+		assert(component_id < m_component_manager->componentCount() && "Component ID not found!");
+		return m_component_infos[component_id];
+	}
+
+	// Number of registered Component types, ComponentIDs are 0 to componentCount() - 1
+	ComponentID componentCount() {
+		return m_component_manager->componentCount();
+	}
+
+	// Calls func(EntityID, void* component) for every Component with 'component_id', in storage order
+	template<typename Func>
+	void eachComponentData(ComponentID component_id, Func func) {
+		if (m_archetype_storage) {
+			Archetype archetype;
+			archetype.set(component_id, true);
+			size_t component_size = m_component_infos[component_id].size;
+			for (auto table_index : m_archetype_storage->matchingTables(archetype)) {
+				DrArchetypeTable* table = m_archetype_storage->getTable(table_index);
+				for (ArrayIndex chunk = 0; chunk < table->chunkCount(); ++chunk) {
+					EntityID* entities = table->entities(chunk);
+					char* components = static_cast<char*>(table->componentArray(chunk, component_id));
+					for (ArrayIndex row = 0; row < table->chunkSize(chunk); ++row) {
+						func(entities[row], static_cast<void*>(components + (row * component_size)));
+					}
+				}
+			}
+		} else {
+			IComponentArray* component_array = m_component_manager->getComponentArray(component_id);
+			for (ArrayIndex i = 0; i < component_array->size(); ++i) {
+				func(component_array->entityAt(i), component_array->dataPointerAt(i));
+			}
+		}
+	}
+
+
+	// Calls func(ArrayIndex count, void* components) for each contiguous run of Components with 'component_id',
+	//		in the same order as eachComponentData(), allows trivially copyable Components to be copied in bulk
+	template<typename Func>
+	void eachComponentBlock(ComponentID component_id, Func func) {
+		if (m_archetype_storage) {
+			Archetype archetype;
+			archetype.set(component_id, true);
+			for (auto table_index : m_archetype_storage->matchingTables(archetype)) {
+				DrArchetypeTable* table = m_archetype_storage->getTable(table_index);
+				for (ArrayIndex chunk = 0; chunk < table->chunkCount(); ++chunk) {
+					func(table->chunkSize(chunk), table->componentArray(chunk, component_id));
+				}
+			}
+		} else {
+			IComponentArray* component_array = m_component_manager->getComponentArray(component_id);
+			for (ArrayIndex page = 0; page < component_array->pageCount(); ++page) {
+				func(component_array->pageSize(page), component_array->pageDataPointer(page));
+			}
+		}
+	}
+
+
+	// #################### Batch Methods (used by DrCommandBuffer) ####################
+	// Adds a run of type erased Components that share a ComponentID, 'data[i]' is copied for 'entities[i]'
+	//		Archetypes / Systems are not updated, call applyArchetypeChange() for each Entity afterwards
+	//		#NOTE: With ECS_STORAGE_ARCHETYPE every call moves each Entity to another table, to change several
+	//			   Components of an Entity use moveComponentData() + constructComponentData() instead
+	void insertComponentData(ComponentID component_id, const EntityID* entities, const void* const* data, size_t count) {
+		if (m_archetype_storage) {
+			for (size_t i = 0; i < count; ++i) m_archetype_storage->addComponent(entities[i], component_id, data[i]);
+		} else {
+			IComponentArray* component_array = m_component_manager->getComponentArray(component_id);
+			for (size_t i = 0; i < count; ++i) component_array->insertDataPointer(entities[i], data[i]);
+		}
+	}
+
+	// Removes a run of Components that share a ComponentID, call applyArchetypeChange() for each Entity afterwards
+	void eraseComponentData(ComponentID component_id, const EntityID* entities, size_t count) {
+		if (m_archetype_storage) {
+			for (size_t i = 0; i < count; ++i) m_archetype_storage->removeComponent(entities[i], component_id);
+		} else {
+			IComponentArray* component_array = m_component_manager->getComponentArray(component_id);
+			for (size_t i = 0; i < count; ++i) component_array->removeData(entities[i]);
+		}
+	}
+
+	// Moves Entity straight to the table of its final Archetype, requires ECS_STORAGE_ARCHETYPE
+	//		Components not in 'archetype' are destroyed, Components new to Entity are left uninitialized until
+	//		constructComponentData(), Archetypes / Systems are not updated, call applyArchetypeChange() afterwards
+	void moveComponentData(EntityID entity, Archetype archetype) {
+		assert(m_archetype_storage != nullptr && "Moving component data requires ECS_STORAGE_ARCHETYPE storage mode!");
+		m_archetype_storage->changeArchetype(entity, archetype);
+	}
+
+	// Copies a run of Components that share a ComponentID into slots left by moveComponentData(), requires ECS_STORAGE_ARCHETYPE
+	void constructComponentData(ComponentID component_id, const EntityID* entities, const void* const* data, size_t count) {
+		assert(m_archetype_storage != nullptr && "Constructing component data requires ECS_STORAGE_ARCHETYPE storage mode!");
+		m_archetype_storage->constructComponents(component_id, entities, data, count);
+	}
+
+	// Same as constructComponentData(), Components are read from a contiguous array of 'count' Components,
+	//		Entities that sit in consecutive rows of a table are filled with one memcpy
+	void constructComponentArray(ComponentID component_id, const EntityID* entities, const void* components, size_t count) {
+		assert(m_archetype_storage != nullptr && "Constructing component data requires ECS_STORAGE_ARCHETYPE storage mode!");
+		m_archetype_storage->constructComponentArray(component_id, entities, components, count);
+	}
+
+	// Replaces an existing Component of Entity with a copy of 'data', Archetype does not change
+	void replaceComponentData(ComponentID component_id, EntityID entity, const void* data) {
+		if (m_archetype_storage) {
+			m_archetype_storage->replaceComponent(entity, component_id, data);
+		} else {
+			void* existing = m_component_manager->getComponentArray(component_id)->getDataPointer(entity);
+			DestroyComponent(m_component_infos[component_id], existing);
+			CopyComponent(m_component_infos[component_id], existing, data);
+		}
+	}
+
+	// Updates Entity Archetype and System membership once after a batch of Component changes
+	void applyArchetypeChange(EntityID entity, Archetype added, Archetype removed) {
+		Archetype archetype = (m_entity_manager->getArchetype(entity) & ~removed) | added;
+		m_entity_manager->setArchetype(entity, archetype);
+		m_system_manager->entityArchetypeChanged(entity, archetype, added | removed);
+	}
+
+
+	// #################### Snapshot Methods ####################
+	// Copies all Entities, Components and System membership into 'snapshot' (ex: before entering play mode)
+	void saveSnapshot(DrEcsSnapshot& snapshot) {
+		m_entity_manager->saveSnapshot(snapshot);
+		if (m_archetype_storage) {
+			m_archetype_storage->saveSnapshot(snapshot);
+		} else {
+			m_component_manager->saveSnapshot(snapshot);
+		}
+		m_system_manager->saveSnapshot(snapshot);
+		snapshot.archetype_storage = (m_archetype_storage != nullptr);
+		snapshot.valid = true;
+	}
+
+	// Returns Coordinator to the state saved in 'snapshot', EntityIDs saved in snapshot are valid again
+	//		Must be restored into the same Coordinator (same Components / Systems registered) it was saved from
+	void restoreSnapshot(const DrEcsSnapshot& snapshot) {
+		assert(snapshot.valid && "Restoring empty snapshot!");
+		assert(snapshot.archetype_storage == (m_archetype_storage != nullptr) && "Snapshot was saved with a different storage mode!");
+		m_entity_manager->restoreSnapshot(snapshot);
+		if (m_archetype_storage) {
+			m_archetype_storage->restoreSnapshot(snapshot);
+		} else {
+			m_component_manager->restoreSnapshot(snapshot);
+		}
+		m_system_manager->restoreSnapshot(snapshot);
+	}
+
+
+	// #################### Query Methods ####################
+	// Returns a query that walks all Entities with Components Ts..., requires ECS_STORAGE_ARCHETYPE
+	template<typename... Ts>
+	DrQuery<Ts...> query() {
+		assert(m_archetype_storage != nullptr && "Queries require ECS_STORAGE_ARCHETYPE storage mode!");
+		std::array<ComponentID, sizeof...(Ts)> ids {{ m_component_manager->getComponentID<Ts>()... }};
+		return DrQuery<Ts...>(m_archetype_storage, ids);
+	}
+
+	// Storage layout of this Coordinator
+	Ecs_Storage storageMode() { return m_storage_mode; }
+
 
 	// #################### System Methods ####################
 	template<typename T>
@@ -131,6 +354,18 @@ public:
 		m_system_manager->setArchetype<T>(archetype);
 	}
 
+	// Declares Components System reads / writes in update(), allows non conflicting Systems to run in parallel
+	template<typename T>
+	void setSystemAccess(Archetype reads, Archetype writes) {
+		m_system_manager->setAccess<T>(reads, writes);
+	}
+
+	// Sends queued Events, then calls update() on all Systems, independent Systems run at the same time on 'pool' if provided
+	void updateSystems(float dt, DrThreadPool* pool = nullptr) {
+		dispatchEvents();
+		m_system_manager->update(dt, pool);
+	}
+
 
 	// #################### Event Methods ####################
 	void addEventListener(EventId eventId, std::function<void(DrEvent&)> const& listener) {
@@ -145,6 +380,32 @@ public:
 		m_event_manager->sendEvent(eventId);
 	}
 
+	// Typed Events, see DrEventManager
+	template<typename E>
+	size_t subscribe(std::function<void(const E&)> const& listener) {
+		return m_event_manager->subscribe<E>(listener);
+	}
+
+	template<typename E>
+	void unsubscribe(size_t handle) {
+		m_event_manager->unsubscribe<E>(handle);
+	}
+
+	template<typename E>
+	void emit(const E& event) {
+		m_event_manager->emit(event);
+	}
+
+	template<typename E>
+	void queueEvent(const E& event) {
+		m_event_manager->queue(event);
+	}
+
+	// Sends Events stored with queueEvent(), called at the start of updateSystems() (call directly if World has no Systems)
+	void dispatchEvents() {
+		m_event_manager->dispatchQueued();
+	}
+
 };
 
 #endif  // DR_ECS_COORDINATOR_H
@@ -11,61 +11,121 @@
 #define DR_ECS_ENTITY_MANAGER_H
 
 // Includes
-#include <array>
-#include <queue>
 #include "engine/data/Constants.h"
+#include "PagedArray.h"
+#include "Snapshot.h"
 
 
 //####################################################################################
 //##    DrEntityManager
-//##        Keeps track of Systems within Coordinator (ECS World)
+//##        Keeps track of Entities within Coordinator (ECS World)
+//##        - EntityIDs are generational handles (index + version, see Constants.h), destroying an Entity bumps
+//##          the version of its slot so stale EntityIDs can be detected with isAlive()
+//##        - Free slots are kept as an implicit linked list inside 'm_entities': a dead slot stores the index of
+//##          the next free slot together with the version its next Entity will use
+//##        - Slots that have used every version (ENTITY_VERSION_MASK + 1 Entities) are retired, they store KEY_NONE
+//##          and are never reused
 //############################
 class DrEntityManager
 {
 	// #################### VARIABLES ####################
 private:
-	std::queue<EntityID> 					m_available_entities	{ };			// Current Entities in Entity Manager
-	std::array<Archetype, MAX_ENTITIES> 	m_archetypes			{ };			// Archetypes of Entities
+	DrPagedVector<EntityID> 				m_entities				{ };			// Alive: EntityID of slot, Dead: next free index + next version
+	DrPagedVector<Archetype> 				m_archetypes			{ };			// Archetypes of Entities, indexed by Entity index
+	EntityID 								m_free_head				{ KEY_NONE };	// First free slot index, KEY_NONE if no recycled slots
 	EntityID 								m_living_entity_count 	{ 0 };			// Tracks number of active Entities
 
 
 	// #################### INTERNAL FUNCTIONS ####################
 public:
-	// Constructor
+	// Constructor, slots are stored in pages that are allocated as Entity count grows
 	DrEntityManager() {
-		// Fill a Queue with available ID Keys
-		for (EntityID entity = KEY_START; entity < MAX_ENTITIES; ++entity) {
-			m_available_entities.push(entity);
-		}
+		// Slot 0 is never handed out so that KEY_NONE is never a valid Entity
+		m_entities.push_back(KEY_NONE);
+		m_archetypes.push_back(Archetype());
 	}
 
-	// Return a valid, unused ID Key
+	// Return a valid, unused EntityID
 	EntityID createEntity() {
 		assert(m_living_entity_count < MAX_ENTITIES && "Too many entities in existence!");
-		EntityID id = m_available_entities.front();
-		m_available_entities.pop();
+		EntityID entity;
+		if (m_free_head != KEY_NONE) {
+			// Recycle slot, its stored value holds the next free index and the version to use
+			EntityID index = m_free_head;
+			m_free_head = GetEntityIndex(m_entities[index]);
+			entity = MakeEntityID(index, GetEntityVersion(m_entities[index]));
+			m_entities[index] = entity;
+		} else {
+			entity = MakeEntityID(static_cast<EntityID>(m_entities.size()), 0);
+			m_entities.push_back(entity);
+			m_archetypes.push_back(Archetype());
+		}
 		++m_living_entity_count;
-		return id;
+		return entity;
 	}
 
-	// Reclaims Entity ID
+	// Reclaims Entity slot, bumps slot version so old EntityID becomes stale
+	//		A slot whose version would wrap back to 0 is retired instead (never handed out again), otherwise
+	//		an EntityID from 2048 reuses ago would be alive again
 	void destroyEntity(EntityID entity) {
-		assert(entity < MAX_ENTITIES && "Entity out of range!");
-		m_archetypes[entity].reset();
-		m_available_entities.push(entity);
+		assert(isAlive(entity) && "Destroying stale or invalid entity!");
+		EntityID index = GetEntityIndex(entity);
+		m_archetypes[index].reset();
+		if (GetEntityVersion(entity) == ENTITY_VERSION_MASK) {
+			m_entities[index] = KEY_NONE;
+		} else {
+			m_entities[index] = MakeEntityID(m_free_head, GetEntityVersion(entity) + 1);
+			m_free_head = index;
+		}
 		--m_living_entity_count;
 	}
 
+	// Returns true if EntityID refers to a currently living Entity (false for stale handles)
+	//		Versions never wrap (see destroyEntity()), so a stale EntityID can't become valid again
+	bool isAlive(EntityID entity) const {
+		EntityID index = GetEntityIndex(entity);
+		return (index >= KEY_START && index < m_entities.size() && m_entities[index] == entity);
+	}
+
 	// Stores Archetype of Entity for fast lookup
 	void setArchetype(EntityID entity, Archetype archetype) {
-		assert((entity >= KEY_START && entity < MAX_ENTITIES) && "Entity out of range!");
-		m_archetypes[entity] = archetype;
+		assert(isAlive(entity) && "Stale or invalid entity!");
+		m_archetypes[GetEntityIndex(entity)] = archetype;
 	}
 
 	// Retrieve Entity Archetype
 	Archetype getArchetype(EntityID entity) {
-		assert((entity >= KEY_START && entity < MAX_ENTITIES) && "Entity out of range!");
-		return m_archetypes[entity];
+		assert(isAlive(entity) && "Stale or invalid entity!");
+		return m_archetypes[GetEntityIndex(entity)];
+	}
+
+	// Number of living Entities
+	EntityID livingCount() const 								{ return m_living_entity_count; }
+
+	// Copies Entity slots, Archetypes and free list into 'snapshot'
+	void saveSnapshot(DrEcsSnapshot& snapshot) const {
+		snapshot.entities.resize(m_entities.size());
+		snapshot.archetypes.resize(m_archetypes.size());
+		m_entities.copyTo(snapshot.entities.data());
+		m_archetypes.copyTo(snapshot.archetypes.data());
+		snapshot.free_head =	m_free_head;
+		snapshot.living_count =	m_living_entity_count;
+	}
+
+	// Replaces Entity slots, Archetypes and free list with those in 'snapshot'
+	void restoreSnapshot(const DrEcsSnapshot& snapshot) {
+		m_entities.assign(snapshot.entities.data(), snapshot.entities.size());
+		m_archetypes.assign(snapshot.archetypes.data(), snapshot.archetypes.size());
+		m_free_head =			snapshot.free_head;
+		m_living_entity_count =	snapshot.living_count;
+	}
+
+	// Calls func(EntityID) for every living Entity, in slot order
+	template<typename Func>
+	void eachEntity(Func func) const {
+		for (EntityID index = KEY_START; index < m_entities.size(); ++index) {
+			if (GetEntityIndex(m_entities[index]) == index) func(m_entities[index]);
+		}
 	}
 
 };
@@ -0,0 +1,78 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_ENTITY_SET_H
+#define DR_ECS_ENTITY_SET_H
+
+// Includes
+#include <vector>
+#include "engine/data/Constants.h"
+#include "PagedArray.h"
+
+
+//####################################################################################
+//##    DrEntitySet
+//##        Sparse set of Entities, O(1) insert / erase / contains with a contiguous list for iteration
+//##        #NOTE: Iteration order is not sorted, erase swaps the last Entity into the removed slot
+//############################
+class DrEntitySet
+{
+	// #################### VARIABLES ####################
+private:
+	DrPagedLookup<ArrayIndex>				m_sparse		{ INDEX_NONE };		// Entity index -> index in 'm_dense', INDEX_NONE if not in set
+	std::vector<EntityID>					m_dense			{ };				// Packed list of Entities in set, capacity is kept once grown
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Returns true if Entity is in set
+	bool contains(EntityID entity) const {
+		EntityID index = GetEntityIndex(entity);
+		assert(index <= MAX_ENTITIES && "Entity out of range!");
+		ArrayIndex dense_index = m_sparse.get(index);
+		return (dense_index != INDEX_NONE && m_dense[dense_index] == entity);
+	}
+
+	// Adds Entity to set, returns false if Entity was already in set
+	bool insert(EntityID entity) {
+		if (contains(entity)) return false;
+		m_sparse.insert(GetEntityIndex(entity), m_dense.size());
+		m_dense.push_back(entity);
+		return true;
+	}
+
+	// Removes Entity from set, returns false if Entity was not in set
+	bool erase(EntityID entity) {
+		if (contains(entity) == false) return false;
+		ArrayIndex index = m_sparse.get(GetEntityIndex(entity));
+		EntityID last = m_dense.back();
+		m_dense[index] = last;
+		m_sparse.at(GetEntityIndex(last)) = index;
+		m_dense.pop_back();
+		m_sparse.erase(GetEntityIndex(entity));
+		return true;
+	}
+
+	// Removes all Entities from set
+	void clear() {
+		m_sparse.clear();
+		m_dense.clear();
+	}
+
+	// Iteration over contiguous Entity list
+	size_t									size() const		{ return m_dense.size(); }
+	bool									empty() const		{ return m_dense.empty(); }
+	const EntityID*							data() const		{ return m_dense.data(); }
+	std::vector<EntityID>::const_iterator	begin() const		{ return m_dense.begin(); }
+	std::vector<EntityID>::const_iterator	end() const			{ return m_dense.end(); }
+
+};
+
+
+#endif	// DR_ECS_ENTITY_SET_H
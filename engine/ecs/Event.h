@@ -10,6 +10,7 @@
 #ifndef DR_ECS_EVENT_H
 #define DR_ECS_EVENT_H
 
+#include <unordered_map>
 #include "3rd_party/any.h"
 #include "engine/data/Constants.h"
 
@@ -48,6 +49,27 @@ namespace Events_Window_Resized {
 }
 
 
+//####################################################################################
+//##    Typed Events
+//##        Payload structs for DrEventManager::emit<E>() / queue<E>(), must be trivially copyable (POD)
+//############################
+struct DrEventWindowQuit {
+};
+
+struct DrEventWindowResized {
+	int				width;
+	int				height;
+};
+
+struct DrEventWindowInput {
+	std::uint32_t	type;															// Input event type (sapp_event_type: key down, mouse move, etc)
+	std::uint32_t	key_code;														// sapp_keycode, or unicode character for SAPP_EVENTTYPE_CHAR
+	std::uint32_t	modifiers;
+	float			mouse_x;
+	float			mouse_y;
+};
+
+
 //####################################################################################
 //##    DrEvent
 //##        Event
@@ -72,7 +94,9 @@ public:
 
 	template<typename T>
 	T getParam(EventId id) {
-		return nonstd::any_cast<T>(m_data[id]);
+		auto it = m_data.find(id);
+		assert(it != m_data.end() && "Event parameter not set!");
+		return nonstd::any_cast<T>(it->second);
 	}
 
 	EventId getType() const {
@@ -10,20 +10,130 @@
 #ifndef DR_ECS_EVENT_MANAGER_H
 #define DR_ECS_EVENT_MANAGER_H
 
+#include <cassert>
+#include <functional>
 #include <list>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "engine/data/Constants.h"
 #include "Event.h"
+#include "TypeIndex.h"
+
+
+//####################################################################################
+//##    IEventChannel / DrEventChannel
+//##        Listeners and queued payloads of one typed Event, see DrEventManager
+//############################
+class IEventChannel
+{
+public:
+	virtual ~IEventChannel() = default;
+	virtual void dispatchQueued() = 0;
+};
+
+template<typename E>
+class DrEventChannel : public IEventChannel
+{
+	// #################### VARIABLES ####################
+public:
+	std::vector<std::function<void(const E&)>>	listeners		{ };			// Empty function marks an unsubscribed slot
+	std::vector<size_t>							free_slots		{ };			// Unsubscribed slots in 'listeners', reused by subscribe()
+	std::vector<E>								queued			{ };			// Payloads waiting for dispatchQueued()
+	std::vector<E>								dispatching		{ };			// Payloads being dispatched, so listeners can queue more
+
+	int											emitting		{ 0 };			// Depth of emit() calls, 'listeners' is not changed while > 0
+	std::vector<std::function<void(const E&)>>	added			{ };			// Subscribed during emit(), appended to 'listeners' afterwards
+	std::vector<size_t>							removed			{ };			// Unsubscribed during emit(), cleared afterwards
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Listeners subscribed during emit() are first called for the next Event, listeners unsubscribed
+	// during emit() are not called again, but are only destroyed once the outermost emit() returns
+	void emit(const E& event) {
+		++emitting;
+		size_t count = listeners.size();
+		for (size_t i = 0; i < count; ++i) {
+			if (listeners[i] && isRemoved(i) == false) listeners[i](event);
+		}
+		if (--emitting == 0) applyChanges();
+	}
+
+	// Events queued during dispatch are held for the next dispatchQueued(), vector capacity is kept between frames
+	void dispatchQueued() override {
+		dispatching.swap(queued);
+		for (auto& event : dispatching) emit(event);
+		dispatching.clear();
+	}
+
+	size_t subscribe(std::function<void(const E&)> const& listener) {
+		if (emitting > 0) {
+			added.push_back(listener);
+			return listeners.size() + added.size() - 1;
+		}
+		if (free_slots.empty() == false) {
+			size_t handle = free_slots.back();
+			free_slots.pop_back();
+			listeners[handle] = listener;
+			return handle;
+		}
+		listeners.push_back(listener);
+		return listeners.size() - 1;
+	}
+
+	void unsubscribe(size_t handle) {
+		assert(isListening(handle) && "Invalid event listener handle!");
+		if (emitting > 0) {
+			removed.push_back(handle);
+			return;
+		}
+		listeners[handle] = nullptr;
+		free_slots.push_back(handle);
+	}
+
+private:
+	bool isRemoved(size_t handle) const {
+		for (size_t removed_handle : removed) {
+			if (removed_handle == handle) return true;
+		}
+		return false;
+	}
+
+	bool isListening(size_t handle) const {
+		if (isRemoved(handle)) return false;
+		if (handle < listeners.size()) return static_cast<bool>(listeners[handle]);
+		return (handle - listeners.size()) < added.size();
+	}
+
+	void applyChanges() {
+		for (auto& listener : added) listeners.push_back(listener);
+		added.clear();
+		for (size_t handle : removed) {
+			listeners[handle] = nullptr;
+			free_slots.push_back(handle);
+		}
+		removed.clear();
+	}
+};
 
 
 //####################################################################################
 //##    DrEventManager
 //##        Keeps track of Events within Coordinator (ECS World)
+//##        - Typed Events: payload structs (see Event.h), listeners stored in a flat list per Event type found by TypeIndex<E>(),
+//##          emit() calls listeners immediately, queue() batches payloads until dispatchQueued() (once per frame: DrApp
+//##          dispatches its window Events at the start of frame(), DrCoordinator at the start of updateSystems()).
+//##          Neither allocates once listener lists / queues have grown to their working size
+//##        - DrEvent (EventId + parameter map) is the older, slower path, kept for existing listeners
 //############################
 class DrEventManager
 {
 	// #################### VARIABLES ####################
 private:
 	std::unordered_map<EventId, std::list<std::function<void(DrEvent&)>>>	listeners;
+	std::vector<std::unique_ptr<IEventChannel>>								m_channels		{ };	// TypeIndex<E>() -> channel, null if Event type unused
 
 
 	// #################### INTERNAL FUNCTIONS ####################
@@ -33,23 +143,78 @@ public:
 	}
 
 	void sendEvent(DrEvent& event) {
-		uint32_t type = event.getType();
+		auto it = listeners.find(event.getType());
+		if (it == listeners.end()) return;
 
-		for (auto const& listener : listeners[type]) {
+		for (auto const& listener : it->second) {
 			listener(event);
 		}
 	}
 
 	void sendEvent(EventId eventId) {
-		DrEvent event(eventId);
+		auto it = listeners.find(eventId);
+		if (it == listeners.end()) return;
 
-		for (auto const& listener : listeners[eventId]) {
+		DrEvent event(eventId);
+		for (auto const& listener : it->second) {
 			listener(event);
 		}
 	}
 
+
+	// #################### Typed Events ####################
+	// Adds listener for Event type E, returns handle for unsubscribe(), safe to call from inside a listener
+	template<typename E>
+	size_t subscribe(std::function<void(const E&)> const& listener) {
+		return getChannel<E>()->subscribe(listener);
+	}
+
+	// Removes listener, handles of other listeners stay valid, the slot is reused by a later subscribe()
+	//		Safe to call from inside a listener (including the listener being removed), removal is deferred until emit() returns
+	template<typename E>
+	void unsubscribe(size_t handle) {
+		getChannel<E>()->unsubscribe(handle);
+	}
+
+	// Calls all listeners of Event type E immediately
+	template<typename E>
+	void emit(const E& event) {
+		DrEventChannel<E>* channel = findChannel<E>();
+		if (channel) channel->emit(event);
+	}
+
+	// Stores Event until next dispatchQueued()
+	template<typename E>
+	void queue(const E& event) {
+		getChannel<E>()->queued.push_back(event);
+	}
+
+	// Sends all queued typed Events, batched by Event type
+	//		Indexed loop, listeners may add channels (queue() / subscribe() of a new Event type) which resizes 'm_channels'
+	void dispatchQueued() {
+		for (size_t i = 0; i < m_channels.size(); ++i) {
+			if (m_channels[i]) m_channels[i]->dispatchQueued();
+		}
+	}
+
+private:
+	template<typename E>
+	DrEventChannel<E>* findChannel() {
+		size_t type_index = TypeIndex<E>();
+		if (type_index >= m_channels.size()) return nullptr;
+		return static_cast<DrEventChannel<E>*>(m_channels[type_index].get());
+	}
+
+	template<typename E>
+	DrEventChannel<E>* getChannel() {
+		static_assert(std::is_trivially_copyable<E>::value, "Typed events must be trivially copyable payload structs!");
+		size_t type_index = TypeIndex<E>();
+		if (type_index >= m_channels.size()) m_channels.resize(type_index + 1);
+		if (m_channels[type_index] == nullptr) m_channels[type_index].reset(new DrEventChannel<E>());
+		return static_cast<DrEventChannel<E>*>(m_channels[type_index].get());
+	}
+
 };
 
 #endif	// DR_ECS_EVENT_MANAGER_H
 
-
@@ -0,0 +1,205 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_PAGED_ARRAY_H
+#define DR_ECS_PAGED_ARRAY_H
+
+// Includes
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "engine/data/Constants.h"
+
+// Local Defines
+#define ECS_PAGE_SIZE       (16 * 1024)                                         // Target byte size of one page of ECS storage
+
+
+//####################################################################################
+//##    DrPagedVector
+//##        Packed array stored in fixed size pages, pages are allocated as the array grows and released as it shrinks
+//##        - Elements never move when the array grows (no reallocation / copying)
+//##        - Elements are only constructed when pushed, empty capacity costs nothing beyond raw page memory
+//############################
+template<typename T>
+class DrPagedVector
+{
+	// #################### LOCAL STRUCTS ####################
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type		Slot;
+
+	// #################### VARIABLES ####################
+private:
+	std::vector<std::unique_ptr<Slot[]>>	m_pages			{ };				// Page memory
+	ArrayIndex								m_size			{ 0 };				// Number of constructed elements
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Constructor / Destructor
+	DrPagedVector() { }
+	~DrPagedVector() { clear(); }
+	DrPagedVector(const DrPagedVector&) = delete;
+	DrPagedVector& operator=(const DrPagedVector&) = delete;
+
+	// Number of elements per page
+	static ArrayIndex pageCapacity() { return (ECS_PAGE_SIZE / sizeof(T) > 0) ? (ECS_PAGE_SIZE / sizeof(T)) : 1; }
+
+	// Element Access
+	T&				operator[](ArrayIndex index)		{ return *reinterpret_cast<T*>(&m_pages[index / pageCapacity()][index % pageCapacity()]); }
+	const T&		operator[](ArrayIndex index) const	{ return *reinterpret_cast<const T*>(&m_pages[index / pageCapacity()][index % pageCapacity()]); }
+	T&				back()								{ return (*this)[m_size - 1]; }
+	ArrayIndex		size() const						{ return m_size; }
+	bool			empty() const						{ return m_size == 0; }
+
+	// Page Access, for iterating elements linearly
+	ArrayIndex		pageCount() const					{ return (m_size + pageCapacity() - 1) / pageCapacity(); }
+	ArrayIndex		pageSize(ArrayIndex page) const {
+		ArrayIndex start = page * pageCapacity();
+		return ((m_size - start) < pageCapacity()) ? (m_size - start) : pageCapacity();
+	}
+	T*				pageData(ArrayIndex page)			{ return reinterpret_cast<T*>(m_pages[page].get()); }
+	const T*		pageData(ArrayIndex page) const		{ return reinterpret_cast<const T*>(m_pages[page].get()); }
+
+	// Adds element to end of array, allocates a new page if needed
+	void push_back(T value) {
+		ArrayIndex page = m_size / pageCapacity();
+		if (page >= m_pages.size()) {
+			m_pages.push_back(std::unique_ptr<Slot[]>(new Slot[pageCapacity()]));
+		}
+		new (&m_pages[page][m_size % pageCapacity()]) T(std::move(value));
+		++m_size;
+	}
+
+	// Removes last element, releases empty pages (keeping one spare to avoid thrashing)
+	void pop_back() {
+		assert(m_size > 0 && "Popping empty paged vector!");
+		back().~T();
+		--m_size;
+		while (m_pages.size() > pageCount() + 1) {
+			m_pages.pop_back();
+		}
+	}
+
+	// Copies all elements to 'destination' (must hold size() elements), one memcpy per page for trivially copyable types
+	void copyTo(T* destination) const {
+		for (ArrayIndex page = 0; page < pageCount(); ++page) {
+			copyRange(destination, pageData(page), pageSize(page), std::is_trivially_copyable<T>());
+			destination += pageSize(page);
+		}
+	}
+
+	// Replaces contents with 'count' elements copied from 'values', pages already allocated are reused
+	void assign(const T* values, ArrayIndex count) {
+		for (ArrayIndex i = 0; i < m_size; ++i) (*this)[i].~T();
+		m_size = 0;
+		ArrayIndex pages = (count + pageCapacity() - 1) / pageCapacity();
+		while (m_pages.size() > pages + 1) m_pages.pop_back();
+		while (m_pages.size() < pages) m_pages.push_back(std::unique_ptr<Slot[]>(new Slot[pageCapacity()]));
+		m_size = count;
+		for (ArrayIndex page = 0; page < pages; ++page) {
+			constructRange(pageData(page), values, pageSize(page), std::is_trivially_copyable<T>());
+			values += pageSize(page);
+		}
+	}
+
+	// Destroys all elements, releases all pages
+	void clear() {
+		for (ArrayIndex i = 0; i < m_size; ++i) (*this)[i].~T();
+		m_size = 0;
+		m_pages.clear();
+	}
+
+	// Bytes of page memory currently allocated
+	size_t memoryUsage() const { return m_pages.size() * pageCapacity() * sizeof(Slot); }
+
+private:
+	// Copy helpers, trivially copyable types use memcpy
+	static void copyRange(T* to, const T* from, ArrayIndex count, std::true_type)		{ memcpy(static_cast<void*>(to), from, count * sizeof(T)); }
+	static void copyRange(T* to, const T* from, ArrayIndex count, std::false_type)		{ for (ArrayIndex i = 0; i < count; ++i) to[i] = from[i]; }
+	static void constructRange(T* to, const T* from, ArrayIndex count, std::true_type)	{ memcpy(static_cast<void*>(to), from, count * sizeof(T)); }
+	static void constructRange(T* to, const T* from, ArrayIndex count, std::false_type)	{ for (ArrayIndex i = 0; i < count; ++i) new (&to[i]) T(from[i]); }
+
+};
+
+
+//####################################################################################
+//##    DrPagedLookup
+//##        Sparse array (ex: Entity index -> value) stored in fixed size pages
+//##        - Pages are allocated on first insert() into their range and kept until clear(), so add / remove churn
+//##          on the same Entities never allocates once their pages exist
+//##        - Unallocated slots read as the 'empty' value passed to the constructor
+//############################
+template<typename T>
+class DrPagedLookup
+{
+	// #################### VARIABLES ####################
+private:
+	std::vector<std::unique_ptr<T[]>>		m_pages			{ };				// Pages, null when page is not allocated
+	T										m_empty;							// Value of unallocated / erased slots
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Constructor
+	explicit DrPagedLookup(T empty_value) : m_empty(empty_value) { }
+
+	// Number of values per page
+	static ArrayIndex pageCapacity() { return (ECS_PAGE_SIZE / sizeof(T) > 0) ? (ECS_PAGE_SIZE / sizeof(T)) : 1; }
+
+	// Returns value at 'index', or 'empty' value if nothing was inserted
+	const T& get(ArrayIndex index) const {
+		ArrayIndex page = index / pageCapacity();
+		if (page >= m_pages.size() || m_pages[page] == nullptr) return m_empty;
+		return m_pages[page][index % pageCapacity()];
+	}
+
+	// Returns reference to a previously inserted value, for updating in place
+	T& at(ArrayIndex index) {
+		ArrayIndex page = index / pageCapacity();
+		assert(page < m_pages.size() && m_pages[page] != nullptr && "Paged lookup slot was never inserted!");
+		return m_pages[page][index % pageCapacity()];
+	}
+
+	// Stores value at previously empty 'index', allocates page if needed
+	void insert(ArrayIndex index, T value) {
+		ArrayIndex page = index / pageCapacity();
+		if (page >= m_pages.size()) {
+			m_pages.resize(page + 1);
+		}
+		if (m_pages[page] == nullptr) {
+			m_pages[page].reset(new T[pageCapacity()]);
+			for (ArrayIndex i = 0; i < pageCapacity(); ++i) m_pages[page][i] = m_empty;
+		}
+		m_pages[page][index % pageCapacity()] = value;
+	}
+
+	// Resets 'index' to empty value, page stays allocated for reuse
+	void erase(ArrayIndex index) {
+		at(index) = m_empty;
+	}
+
+	// Releases all pages
+	void clear() {
+		m_pages.clear();
+	}
+
+	// Bytes of page memory currently allocated
+	size_t memoryUsage() const {
+		size_t bytes = m_pages.size() * sizeof(std::unique_ptr<T[]>);
+		for (auto& page : m_pages) if (page) bytes += pageCapacity() * sizeof(T);
+		return bytes;
+	}
+
+};
+
+
+#endif	// DR_ECS_PAGED_ARRAY_H
@@ -0,0 +1,101 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_QUERY_H
+#define DR_ECS_QUERY_H
+
+// Includes
+#include <array>
+#include "engine/data/Constants.h"
+#include "ArchetypeStorage.h"
+
+
+//####################################################################################
+//##    Index sequence helper (std::index_sequence is C++14)
+//############################
+template<size_t... Is> struct DrIndices { };
+template<size_t N, size_t... Is> struct DrMakeIndices : DrMakeIndices<N - 1, N - 1, Is...> { };
+template<size_t... Is> struct DrMakeIndices<0, Is...> { typedef DrIndices<Is...> type; };
+
+
+//####################################################################################
+//##    DrQuery
+//##        Walks all Archetype chunks containing Components Ts..., ex:
+//##            ecs->query<Transform2D, Velocity>().each([](EntityID entity, Transform2D& t, Velocity& v) { ... });
+//##            ecs->query<Transform2D, Velocity>().eachChunk([](ArrayIndex count, EntityID* entities, Transform2D* t, Velocity* v) { ... });
+//##        Matching tables are cached by DrArchetypeStorage, so building a query each frame is cheap
+//##        #NOTE: Do not add / remove Components or Entities while iterating a query
+//############################
+template<typename... Ts>
+class DrQuery
+{
+	// #################### LOCAL STRUCTS ####################
+	// Adapts a per Entity function to a per chunk function
+	template<typename Func>
+	struct DrEachRow {
+		Func& func;
+		template<typename... Us>
+		void operator()(ArrayIndex count, EntityID* entities, Us*... arrays) {
+			for (ArrayIndex i = 0; i < count; ++i) {
+				func(entities[i], arrays[i]...);
+			}
+		}
+	};
+
+	// #################### VARIABLES ####################
+private:
+	DrArchetypeStorage*						m_storage		{ nullptr };		// Storage to iterate
+	std::array<ComponentID, sizeof...(Ts)>	m_ids			{ };				// ComponentIDs of Ts...
+	Archetype								m_archetype		{ };				// Combined bitset of Ts...
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	DrQuery(DrArchetypeStorage* storage, std::array<ComponentID, sizeof...(Ts)> ids) : m_storage(storage), m_ids(ids) {
+		for (auto id : m_ids) m_archetype.set(id, true);
+	}
+
+	// Calls func(ArrayIndex count, EntityID* entities, Ts*... components) once per matching chunk
+	template<typename Func>
+	void eachChunk(Func func) {
+		walkChunks(func, typename DrMakeIndices<sizeof...(Ts)>::type());
+	}
+
+	// Calls func(EntityID entity, Ts&... components) once per matching Entity
+	template<typename Func>
+	void each(Func func) {
+		DrEachRow<Func> row_func { func };
+		walkChunks(row_func, typename DrMakeIndices<sizeof...(Ts)>::type());
+	}
+
+	// Number of Entities matching query
+	ArrayIndex count() {
+		ArrayIndex total = 0;
+		for (auto table_index : m_storage->matchingTables(m_archetype)) {
+			total += m_storage->getTable(table_index)->size();
+		}
+		return total;
+	}
+
+private:
+	template<typename Func, size_t... Is>
+	void walkChunks(Func& func, DrIndices<Is...>) {
+		for (auto table_index : m_storage->matchingTables(m_archetype)) {
+			DrArchetypeTable* table = m_storage->getTable(table_index);
+			ArrayIndex chunk_count = table->chunkCount();
+			for (ArrayIndex chunk = 0; chunk < chunk_count; ++chunk) {
+				func(table->chunkSize(chunk), table->entities(chunk), static_cast<Ts*>(table->componentArray(chunk, m_ids[Is]))...);
+			}
+		}
+	}
+
+};
+
+
+#endif	// DR_ECS_QUERY_H
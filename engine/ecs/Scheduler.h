@@ -0,0 +1,99 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_SCHEDULER_H
+#define DR_ECS_SCHEDULER_H
+
+// Includes
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "engine/app/core/ThreadPool.h"
+#include "engine/data/Constants.h"
+#include "System.h"
+
+
+//####################################################################################
+//##    DrSystemScheduler
+//##        Runs System updates on a DrThreadPool using a dependency graph built from declared Component access
+//##        - Systems are ordered by registration, a System depends on every earlier System it conflicts with
+//##        - Two Systems conflict if either one writes a Component the other reads or writes
+//##        - Systems that declare no access at all conflict with every System (run on their own)
+//##        - Structural changes (add / remove Components, create / destroy Entities) during update() should go through a DrCommandBuffer
+//############################
+class DrSystemScheduler
+{
+	// #################### LOCAL STRUCTS ####################
+	struct DrSystemNode {
+		std::vector<ArrayIndex>		dependents		{ };						// Systems that must wait for this System
+		int							dependencies	{ 0 };						// Number of Systems this System waits for
+	};
+
+	// #################### VARIABLES ####################
+private:
+	std::vector<DrSystemNode>				m_nodes			{ };				// Dependency graph, same index as System list
+	std::unique_ptr<std::atomic<int>[]>		m_remaining		{ };				// Unfinished dependencies of each System for current run
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Builds dependency graph from System read / write Archetypes
+	void build(const std::vector<std::shared_ptr<DrSystem>>& systems) {
+		m_nodes.assign(systems.size(), DrSystemNode());
+		m_remaining.reset(new std::atomic<int>[systems.size()]);
+		for (ArrayIndex later = 0; later < systems.size(); ++later) {
+			for (ArrayIndex earlier = 0; earlier < later; ++earlier) {
+				if (conflicts(*systems[earlier], *systems[later])) {
+					m_nodes[earlier].dependents.push_back(later);
+					m_nodes[later].dependencies++;
+				}
+			}
+		}
+	}
+
+	// Runs update() of all Systems, returns when every System has finished
+	//		Without a pool (or with a pool of zero threads), Systems run in registration order on calling thread
+	void run(const std::vector<std::shared_ptr<DrSystem>>& systems, float dt, DrThreadPool* pool) {
+		assert(m_nodes.size() == systems.size() && "Scheduler must be rebuilt after registering systems!");
+		if (pool == nullptr || pool->threadCount() == 0) {
+			for (auto& system : systems) system->update(dt);
+			return;
+		}
+
+		DrJobCounter counter;
+		for (ArrayIndex i = 0; i < m_nodes.size(); ++i) {
+			m_remaining[i].store(m_nodes[i].dependencies);
+		}
+		for (ArrayIndex i = 0; i < m_nodes.size(); ++i) {
+			if (m_nodes[i].dependencies == 0) submit(systems, i, dt, pool, &counter);
+		}
+		pool->wait(counter);
+	}
+
+private:
+	// Returns true if Systems cannot run at the same time
+	static bool conflicts(const DrSystem& a, const DrSystem& b) {
+		if ((a.m_reads | a.m_writes).none() || (b.m_reads | b.m_writes).none()) return true;
+		return (a.m_writes & (b.m_reads | b.m_writes)).any() || (b.m_writes & a.m_reads).any();
+	}
+
+	// Queues System update, when finished releases any dependent Systems that are now ready
+	void submit(const std::vector<std::shared_ptr<DrSystem>>& systems, ArrayIndex index, float dt, DrThreadPool* pool, DrJobCounter* counter) {
+		pool->submit([this, &systems, index, dt, pool, counter]() {
+			systems[index]->update(dt);
+			for (auto dependent : m_nodes[index].dependents) {
+				if (m_remaining[dependent].fetch_sub(1) == 1) submit(systems, dependent, dt, pool, counter);
+			}
+		}, counter);
+	}
+
+};
+
+
+#endif	// DR_ECS_SCHEDULER_H
@@ -0,0 +1,163 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_SNAPSHOT_H
+#define DR_ECS_SNAPSHOT_H
+
+// Includes
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "engine/data/Constants.h"
+#include "ComponentInfo.h"
+
+
+//####################################################################################
+//##    DrComponentBuffer
+//##        Type erased, contiguous array of Components, owns the copies it holds
+//##        - Trivially copyable Components are appended with one memcpy per block
+//############################
+class DrComponentBuffer
+{
+	// #################### VARIABLES ####################
+private:
+	DrComponentInfo								m_info			{ };				// Type info of stored Components
+	std::unique_ptr<std::max_align_t[]>			m_data			{ };				// Component memory
+	ArrayIndex									m_size			{ 0 };				// Number of constructed Components
+	ArrayIndex									m_capacity		{ 0 };				// Number of Components that fit in 'm_data'
+
+
+	// #################### INTERNAL FUNCTIONS ####################
+public:
+	// Constructor / Destructor
+	DrComponentBuffer() { }
+	explicit DrComponentBuffer(const DrComponentInfo& info) : m_info(info) {
+		assert(info.align <= alignof(std::max_align_t) && "Component alignment too large for component buffer!");
+	}
+	~DrComponentBuffer() { clear(); }
+	DrComponentBuffer(const DrComponentBuffer&) = delete;
+	DrComponentBuffer& operator=(const DrComponentBuffer&) = delete;
+	DrComponentBuffer(DrComponentBuffer&& other) noexcept :
+		m_info(other.m_info), m_data(std::move(other.m_data)), m_size(other.m_size), m_capacity(other.m_capacity) {
+		other.m_size = 0;
+		other.m_capacity = 0;
+	}
+	DrComponentBuffer& operator=(DrComponentBuffer&& other) noexcept {
+		if (this == &other) return *this;
+		clear();
+		m_info =		other.m_info;
+		m_data =		std::move(other.m_data);
+		m_size =		other.m_size;
+		m_capacity =	other.m_capacity;
+		other.m_size = 0;
+		other.m_capacity = 0;
+		return *this;
+	}
+
+	// Buffer Info
+	const DrComponentInfo&	info() const									{ return m_info; }
+	ArrayIndex				size() const									{ return m_size; }
+	const void*				data() const									{ return m_data.get(); }
+	size_t					memoryUsage() const								{ return m_capacity * m_info.size; }
+
+	// Makes room for 'count' Components, must be called before any Components are appended
+	void reserve(ArrayIndex count) {
+		assert(m_size == 0 && "Component buffer can only be reserved while empty!");
+		if (count <= m_capacity) return;
+		size_t blocks = ((count * m_info.size) + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+		m_data.reset(new std::max_align_t[blocks]);
+		m_capacity = count;
+	}
+
+	// Copies 'count' contiguous Components from 'components' to end of buffer
+	void append(const void* components, ArrayIndex count) {
+		assert(m_size + count <= m_capacity && "Component buffer overflow, reserve() first!");
+		char* dst = reinterpret_cast<char*>(m_data.get()) + (m_size * m_info.size);
+		if (m_info.trivial) {
+			if (count > 0) memcpy(dst, components, count * m_info.size);
+		} else {
+			const char* src = static_cast<const char*>(components);
+			for (ArrayIndex i = 0; i < count; ++i) m_info.copy(dst + (i * m_info.size), src + (i * m_info.size));
+		}
+		m_size += count;
+	}
+
+	// Destroys all Components, keeps memory
+	void clear() {
+		char* components = reinterpret_cast<char*>(m_data.get());
+		for (ArrayIndex i = 0; i < m_size; ++i) DestroyComponent(m_info, components + (i * m_info.size));
+		m_size = 0;
+	}
+
+};
+
+
+//####################################################################################
+//##    DrEcsSnapshot
+//##        Copy of the complete state of a DrCoordinator (Entities, Components, System membership),
+//##        filled by DrCoordinator::saveSnapshot() and applied with DrCoordinator::restoreSnapshot()
+//##        - All state is copied as contiguous blocks, a snapshot is plain memory with no hooks into the
+//##          Coordinator, so holding one costs nothing per frame
+//##        - Events, queued commands and Systems / Components registered after saving are not part of a snapshot
+//############################
+struct DrEcsSnapshot {
+	// Local Structs
+	struct DrComponentArraySnapshot {											// ECS_STORAGE_SPARSE_SET, one per ComponentID
+		std::vector<EntityID>			entities;									// Packed Entity list
+		DrComponentBuffer				components;									// Packed Components, same order as 'entities'
+	};
+	struct DrTableSnapshot {													// ECS_STORAGE_ARCHETYPE, one per Archetype table
+		Archetype						archetype;									// Archetype of table
+		std::vector<EntityID>			entities;									// Rows of table
+		std::vector<DrComponentBuffer>	columns;									// One per Component of table, in table Component order
+	};
+
+	// Entity Manager
+	std::vector<EntityID>					entities			{ };				// Entity slots (alive EntityIDs and free list links)
+	std::vector<Archetype>					archetypes			{ };				// Archetype of each Entity slot
+	EntityID								free_head			{ KEY_NONE };		// First free Entity slot
+	EntityID								living_count		{ 0 };				// Number of living Entities
+
+	// Components
+	std::vector<DrComponentArraySnapshot>	component_arrays	{ };
+	std::vector<DrTableSnapshot>			tables				{ };
+
+	// Systems
+	std::vector<std::vector<EntityID>>		system_entities		{ };				// Entities of each System, in System order
+
+	// Snapshot Info
+	bool									archetype_storage	{ false };			// Saved from a Coordinator using ECS_STORAGE_ARCHETYPE
+	bool									valid				{ false };			// True once filled by saveSnapshot()
+
+	// Releases all memory held by snapshot
+	void clear() {
+		entities.clear();			entities.shrink_to_fit();
+		archetypes.clear();			archetypes.shrink_to_fit();
+		component_arrays.clear();
+		tables.clear();
+		system_entities.clear();
+		valid = false;
+	}
+
+	// Bytes of memory held by snapshot
+	size_t memoryUsage() const {
+		size_t bytes = entities.capacity() * sizeof(EntityID) + archetypes.capacity() * sizeof(Archetype);
+		for (auto& array : component_arrays) bytes += array.entities.capacity() * sizeof(EntityID) + array.components.memoryUsage();
+		for (auto& table : tables) {
+			bytes += table.entities.capacity() * sizeof(EntityID);
+			for (auto& column : table.columns) bytes += column.memoryUsage();
+		}
+		for (auto& list : system_entities) bytes += list.capacity() * sizeof(EntityID);
+		return bytes;
+	}
+};
+
+
+#endif	// DR_ECS_SNAPSHOT_H
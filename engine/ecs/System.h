@@ -10,8 +10,8 @@
 #ifndef DR_ECS_SYSTEM_H
 #define DR_ECS_SYSTEM_H
 
-#include <set>
 #include "engine/data/Constants.h"
+#include "EntitySet.h"
 
 
 //####################################################################################
@@ -22,7 +22,9 @@ class DrSystem
 {
     // #################### VARIABLES ####################
 public:
-	std::set<EntityID>      m_entities;
+	DrEntitySet             m_entities;                         // Entities with matching Archetype, contiguous for fast update() loops
+	Archetype               m_reads;                            // Components read in update(), used by DrSystemScheduler
+	Archetype               m_writes;                           // Components written in update(), used by DrSystemScheduler
 
 
     // #################### FUNCTIONS TO BE EXPOSED TO API ####################
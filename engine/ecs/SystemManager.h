@@ -10,7 +10,12 @@
 #ifndef DR_ECS_SYSTEM_MANAGER_H
 #define DR_ECS_SYSTEM_MANAGER_H
 
+#include <algorithm>
+#include <array>
 #include <unordered_map>
+#include <vector>
+#include "Scheduler.h"
+#include "Snapshot.h"
 #include "System.h"
 
 
@@ -22,8 +27,13 @@ class DrSystemManager
 {
 	// #################### VARIABLES ####################
 private:
-	std::unordered_map<HashID, std::shared_ptr<DrSystem>> 	m_systems 		{ };	// Current Systems in System Manager
-	std::unordered_map<HashID, Archetype>     				m_archetypes 	{ };	// Archetypes of Systems
+	std::vector<std::shared_ptr<DrSystem>>					m_systems 			{ };	// Current Systems in System Manager
+	std::vector<Archetype>									m_archetypes 		{ };	// Archetypes of Systems, same index as 'm_systems'
+	std::unordered_map<HashID, ArrayIndex>					m_system_index		{ };	// typeid().hash_code() of System -> index in 'm_systems'
+	std::array<std::vector<ArrayIndex>, MAX_COMPONENTS>		m_component_systems	{ };	// Component -> Systems whose Archetype includes that Component
+	std::vector<ArrayIndex>									m_any_systems		{ };	// Systems with an empty Archetype (interested in all Entities)
+	DrSystemScheduler										m_scheduler			{ };	// Runs System updates in parallel
+	bool													m_scheduler_dirty	{ true };	// Rebuild scheduler graph before next update
 
 
 	// #################### INTERNAL FUNCTIONS ####################
@@ -32,47 +42,123 @@ public:
 	template<typename T>
 	std::shared_ptr<T> registerSystem() {
 		HashID hash = typeid(T).hash_code();
-		assert(m_systems.find(hash) == m_systems.end() && "Registering system more than once!");
+		assert(m_system_index.find(hash) == m_system_index.end() && "Registering system more than once!");
 
 		// Otherwise, add system to manager
 		auto system = std::make_shared<T>();
-		m_systems.insert({hash, system});
+		m_system_index.insert({hash, m_systems.size()});
+		m_systems.push_back(system);
+		m_archetypes.push_back(Archetype());
+		m_any_systems.push_back(m_systems.size() - 1);
+		m_scheduler_dirty = true;
 		return system;
 	}
 
+	// Sets Components a System reads / writes during update(), Systems with no conflicting access can update at the same time
+	template<typename T>
+	void setAccess(Archetype reads, Archetype writes) {
+		HashID hash = typeid(T).hash_code();
+		assert(m_system_index.find(hash) != m_system_index.end() && "System used before being registered!");
+		DrSystem* system = m_systems[m_system_index[hash]].get();
+		system->m_reads =  reads;
+		system->m_writes = writes;
+		m_scheduler_dirty = true;
+	}
+
+	// Updates all Systems, in parallel when a thread pool is provided
+	void update(float dt, DrThreadPool* pool) {
+		if (m_scheduler_dirty) {
+			m_scheduler.build(m_systems);
+			m_scheduler_dirty = false;
+		}
+		m_scheduler.run(m_systems, dt, pool);
+	}
+
 	// Sets Archetype (a bitset based on desired Components) of a System
 	template<typename T>
 	void setArchetype(Archetype archetype) {
 		HashID hash = typeid(T).hash_code();
-		assert(m_systems.find(hash) != m_systems.end() && "System used before being registered!");
-		m_archetypes.insert({hash, archetype});
+		assert(m_system_index.find(hash) != m_system_index.end() && "System used before being registered!");
+		ArrayIndex index = m_system_index[hash];
+
+		// Remove from old Component index, add to new
+		unindexSystem(index);
+		m_archetypes[index] = archetype;
+		if (archetype.none()) {
+			m_any_systems.push_back(index);
+		} else {
+			for (ComponentID id = 0; id < MAX_COMPONENTS; ++id) {
+				if (archetype.test(id)) m_component_systems[id].push_back(index);
+			}
+		}
 	}
 
 	// Entity has been destroyed, remove from all Systems
 	void entityDestroyed(EntityID entity) {
-		for (auto const& system_pair : m_systems) {
-			auto const& system = system_pair.second;
+		for (auto const& system : m_systems) {
 			system->m_entities.erase(entity);
 		}
 	}
 
-	// Check all Systems for Entity
+	// Check Systems interested in changed Component for Entity
 	//		If Entity has necessay components of System (shares Archetype), make sure that Entity is included in that System
 	//		Otherwise remove the Entity from that System
-	void entityArchetypeChanged(EntityID entity, Archetype entity_archetype) {
-		for (auto const& system_pair : m_systems) {
-			auto const& type =   system_pair.first;
-			auto const& system = system_pair.second;
-			auto const& system_archetype = m_archetypes[type];
+	//		Systems that don't use 'changed_component' can't have changed membership, so they are skipped
+	void entityArchetypeChanged(EntityID entity, Archetype entity_archetype, ComponentID changed_component) {
+		testSystems(entity, entity_archetype, m_component_systems[changed_component]);
+		testSystems(entity, entity_archetype, m_any_systems);
+	}
+
+	// Same as above, for when multiple Components have changed at once ('changed_components' has a bit set for each)
+	void entityArchetypeChanged(EntityID entity, Archetype entity_archetype, Archetype changed_components) {
+		for (ComponentID id = 0; id < MAX_COMPONENTS; ++id) {
+			if (changed_components.test(id)) testSystems(entity, entity_archetype, m_component_systems[id]);
+		}
+		testSystems(entity, entity_archetype, m_any_systems);
+	}
+
+	// Copies Entity list of each System into 'snapshot'
+	void saveSnapshot(DrEcsSnapshot& snapshot) const {
+		snapshot.system_entities.resize(m_systems.size());
+		for (size_t i = 0; i < m_systems.size(); ++i) {
+			snapshot.system_entities[i].assign(m_systems[i]->m_entities.begin(), m_systems[i]->m_entities.end());
+		}
+	}
+
+	// Replaces Entity list of each System with those in 'snapshot', keeps iteration order
+	void restoreSnapshot(const DrEcsSnapshot& snapshot) {
+		assert(snapshot.system_entities.size() == m_systems.size() && "Snapshot was saved with different Systems registered!");
+		for (size_t i = 0; i < m_systems.size(); ++i) {
+			DrEntitySet& entities = m_systems[i]->m_entities;
+			entities.clear();
+			for (auto entity : snapshot.system_entities[i]) entities.insert(entity);
+		}
+	}
 
+private:
+	// Adds / removes Entity from each System in 'systems' based on Archetype
+	void testSystems(EntityID entity, const Archetype& entity_archetype, const std::vector<ArrayIndex>& systems) {
+		for (auto index : systems) {
+			auto const& system_archetype = m_archetypes[index];
 			if ((entity_archetype & system_archetype) == system_archetype) {
-				system->m_entities.insert(entity);
+				m_systems[index]->m_entities.insert(entity);
 			} else {
-				system->m_entities.erase(entity);
+				m_systems[index]->m_entities.erase(entity);
 			}
 		}
 	}
 
+	// Removes System from Component lookups
+	void unindexSystem(ArrayIndex index) {
+		auto remove = [index](std::vector<ArrayIndex>& list) {
+			list.erase(std::remove(list.begin(), list.end(), index), list.end());
+		};
+		remove(m_any_systems);
+		for (ComponentID id = 0; id < MAX_COMPONENTS; ++id) {
+			if (m_archetypes[index].test(id)) remove(m_component_systems[id]);
+		}
+	}
+
 };
 
 
@@ -0,0 +1,36 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_ECS_TYPE_INDEX_H
+#define DR_ECS_TYPE_INDEX_H
+
+// Includes
+#include <atomic>
+#include <cstddef>
+
+
+//####################################################################################
+//##    TypeIndex
+//##        Small sequential index unique to each Type, assigned the first time TypeIndex<T>() is called
+//##        - Process wide (not per Coordinator), use it to index flat lookup tables instead of hashing typeid()
+//##        - Values are not stable between runs, never serialize them
+//############################
+inline size_t NextTypeIndex() {
+	static std::atomic<size_t> s_next_type_index { 0 };
+	return s_next_type_index++;
+}
+
+template<typename T>
+inline size_t TypeIndex() {
+	static const size_t s_type_index = NextTypeIndex();
+	return s_type_index;
+}
+
+
+#endif	// DR_ECS_TYPE_INDEX_H
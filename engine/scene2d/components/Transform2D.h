@@ -18,15 +18,23 @@
 //####################################################################################
 //##    ECS Component: Transform2D
 //##        Used to descibe a location of a 2D object in space
+//##        Plain old data (fixed size arrays, no heap memory), can be copied / serialized with memcpy
 //############################
 struct Transform2D {
-	std::vector<double>		position;
-	std::vector<double> 	rotation;
-	std::vector<double>		scale_xyz;
+	double					position[3]			{ };
+	double					rotation[3]			{ };
+	double					scale_xyz[3]		{ };
 
 	REFLECT();
 };
 
+// Compile time member table
+REFLECT_POD(Transform2D)
+	REFLECT_POD_MEMBER(position)
+	REFLECT_POD_MEMBER(rotation)
+	REFLECT_POD_MEMBER(scale_xyz)
+REFLECT_POD_END()
+
 
 //####################################################################################
 //##    Register Reflection / Meta Data
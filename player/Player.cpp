@@ -8,7 +8,13 @@
 //
 ///////////////////////////////////////////////////////////////////////////////////*/
 
+#include "engine/app/core/Reflect.h"
+#include "engine/app/image/Image.h"
+#include "engine/app/resources/AssetPack.h"
+#include "engine/app/resources/ImageManager.h"
 #include "engine/app/App.h"
+#include "engine/ecs/Coordinator.h"
+#include "engine/scene2d/components/Transform2D.h"
 
 
 //####################################################################################
@@ -19,6 +25,29 @@ class DrPlayer : public DrApp
 public:
     using DrApp::DrApp;                                                             // Inherits base constructor, requires C++ 11
 
+    DrAssetPack     assets;                                                         // Pre-decoded project assets
+    std::map<std::string, std::shared_ptr<DrImage>> images;                         // Images loaded from 'assets', by asset name
+    std::shared_ptr<DrCoordinator>                  scene   { nullptr };            // First scene in 'assets', nullptr if pack has none
+
+    // Loads every bitmap in the asset pack (no file fetch / decode), and the first scene found
+    virtual void onCreate() override {
+        if (assets.isOpen() == false) return;
+
+        for (std::uint32_t index = 0; index < assets.entryCount(); ++index) {
+            const DrAssetPackEntry& entry = assets.entry(index);
+            std::string asset_name = assets.name(entry);
+
+            if (entry.type == ASSET_PACK_BITMAP) {
+                imageManager()->loadImageFromPack(assets, ImageLoadData(images[asset_name], asset_name, ATLAS_TYPE_2D_GAME));
+
+            } else if (entry.type == ASSET_PACK_SCENE && scene == nullptr) {
+                scene = std::make_shared<DrCoordinator>();
+                scene->registerComponent<Transform2D>();
+                if (assets.loadScene(asset_name, scene.get()) == false) scene = nullptr;
+            }
+        }
+    }
+
     virtual void onUpdateGUI() override {
 
         #if defined(DROP_IMGUI)
@@ -40,7 +69,11 @@ public:
 
 int main(int argc, char* argv[]) {
 
+    // Turn on reflection, scenes are matched to Components by reflected names
+    InitializeReflection();
+
     DrPlayer* player = new DrPlayer("Test Player", DROP_COLOR_PURPLE);
+    if (argc > 1) player->assets.open(argv[1]);                                     // Optional asset pack path
     player->run();
 
 }
\ No newline at end of file
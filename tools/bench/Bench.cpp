@@ -0,0 +1,77 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "Bench.h"
+
+// Globals
+static volatile double g_bench_sink { 0.0 };
+static std::atomic<long> g_bench_allocations { 0 };
+
+
+//####################################################################################
+//##    Allocation Counting
+//##        Replaces global operator new / delete so benchmarks can report heap allocations
+//####################################################################################
+void* operator new(std::size_t size) {
+    g_bench_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc((size > 0) ? size : 1);
+    if (memory == nullptr) throw std::bad_alloc();
+    return memory;
+}
+void* operator new[](std::size_t size)              { return operator new(size); }
+void operator delete(void* memory) noexcept         { std::free(memory); }
+void operator delete[](void* memory) noexcept       { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept    { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept  { std::free(memory); }
+
+
+//####################################################################################
+//##    Registry
+//####################################################################################
+std::vector<DrBenchmark>& Benchmarks() {
+    static std::vector<DrBenchmark> benchmarks;
+    return benchmarks;
+}
+
+void BenchKeep(double value) {
+    g_bench_sink = g_bench_sink + value;
+}
+
+long BenchAllocations() {
+    return g_bench_allocations.load(std::memory_order_relaxed);
+}
+
+
+//####################################################################################
+//##    Program Start
+//####################################################################################
+int main(int argc, char* argv[]) {
+    std::vector<DrBenchmark> benchmarks = Benchmarks();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const DrBenchmark& a, const DrBenchmark& b) { return a.name < b.name; });
+
+    int ran = 0;
+    for (auto& benchmark : benchmarks) {
+        bool selected = (argc < 2);
+        for (int arg = 1; arg < argc; ++arg) {
+            if (benchmark.name.find(argv[arg]) != std::string::npos) selected = true;
+        }
+        if (selected == false) continue;
+
+        printf("== %s\n", benchmark.name.c_str());
+        fflush(stdout);
+        benchmark.run();
+        printf("\n");
+        ++ran;
+    }
+    if (ran == 0) printf("No benchmark matches filter\n");
+    return 0;
+}
@@ -0,0 +1,77 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#ifndef DR_BENCH_H
+#define DR_BENCH_H
+
+// Includes
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+//####################################################################################
+//##    Benchmark Registry
+//##        BENCHMARK(name) { ... } adds a function to the list run by drop_bench, benchmarks are run in
+//##        name order and 'name' is matched against command line filters
+//############################
+struct DrBenchmark {
+    std::string     name;
+    void            (*run)();
+};
+std::vector<DrBenchmark>&   Benchmarks();
+
+struct DrBenchmarkRegister {
+    DrBenchmarkRegister(const char* name, void (*run)()) { Benchmarks().push_back({ name, run }); }
+};
+
+#define BENCHMARK(NAME) \
+    static void Bench_##NAME(); \
+    static DrBenchmarkRegister g_register_##NAME(#NAME, &Bench_##NAME); \
+    static void Bench_##NAME()
+
+
+//####################################################################################
+//##    Timing
+//############################
+class DrBenchTimer
+{
+private:
+    std::chrono::steady_clock::time_point   m_start;
+
+public:
+    DrBenchTimer() : m_start(std::chrono::steady_clock::now()) { }
+    void    restart()       { m_start = std::chrono::steady_clock::now(); }
+    double  ms() const      { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count(); }
+};
+
+// Returns fastest time (milliseconds) of 'runs' calls to 'func'
+template <typename Function>
+double BenchBest(int runs, Function func) {
+    double best = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        DrBenchTimer timer;
+        func();
+        double time = timer.ms();
+        if (run == 0 || time < best) best = time;
+    }
+    return best;
+}
+
+// Keeps optimizer from removing work whose result is otherwise unused
+void BenchKeep(double value);
+
+// Number of heap allocations (global operator new) made by the program so far
+long BenchAllocations();
+
+
+#endif  // DR_BENCH_H
@@ -0,0 +1,153 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <string>
+#include "engine/app/image/Color.h"
+
+// Benchmark Components are registered with reflection here (drop_bench does not build engine/data/Reflect.cpp)
+#define REGISTER_REFLECTION
+#include "engine/app/core/Reflect.h"
+#include "engine/scene2d/components/Transform2D.h"
+#include "engine/data/Serialize.h"
+#include "engine/data/Undo.h"
+#include "engine/ecs/Coordinator.h"
+#include "Bench.h"
+
+
+//####################################################################################
+//##    Reflected Benchmark Components
+//####################################################################################
+// Not trivially copyable, saved / loaded member by member
+struct BenchName {
+    std::string     name;
+    int             id;
+
+    REFLECT();
+};
+
+REFLECT_CLASS(BenchName)
+    REFLECT_MEMBER(name)
+    REFLECT_MEMBER(id)
+REFLECT_END(BenchName)
+
+// Reflection is initialized once, before the first data benchmark
+static void InitializeBenchReflection() {
+    if (g_reflect == nullptr) InitializeReflection();
+}
+
+// Scene of 'count' Entities, every Entity has a Transform2D, every tenth Entity also has a BenchName
+static void BuildScene(DrCoordinator& ecs, int count) {
+    ecs.registerComponent<Transform2D>();
+    ecs.registerComponent<BenchName>();
+    for (int i = 0; i < count; ++i) {
+        EntityID entity = ecs.createEntity();
+        Transform2D transform { };
+            transform.position[0] =  static_cast<double>(i);
+            transform.scale_xyz[0] = 1.0;   transform.scale_xyz[1] = 1.0;   transform.scale_xyz[2] = 1.0;
+        ecs.addComponent(entity, transform);
+        if (i % 10 == 0) {
+            BenchName name { };
+                name.name = "Entity " + std::to_string(i);
+                name.id =   i;
+            ecs.addComponent(entity, name);
+        }
+    }
+}
+
+
+//####################################################################################
+//##    Scene Serialization
+//##        Save / load throughput of a 100k Entity scene
+//####################################################################################
+static void BenchSceneSerialize(Ecs_Storage storage_mode, const char* label, int count) {
+    DrCoordinator ecs(storage_mode);
+    BuildScene(ecs, count);
+
+    std::vector<char> buffer;
+    double save_ms = BenchBest(5, [&]() {
+        buffer.clear();
+        bool saved = SerializeScene(&ecs, buffer);
+        assert(saved && "Could not serialize benchmark scene!");
+    });
+    double load_ms = BenchBest(5, [&]() {
+        DrCoordinator loaded(storage_mode);
+        loaded.registerComponent<Transform2D>();
+        loaded.registerComponent<BenchName>();
+        bool ok = DeserializeScene(&loaded, buffer.data(), buffer.size());
+        assert(ok && loaded.entityCount() == static_cast<size_t>(count) && "Could not deserialize benchmark scene!");
+        BenchKeep(ok ? 1.0 : 0.0);
+    });
+
+    double megabytes = buffer.size() / (1024.0 * 1024.0);
+    printf("  %-22s %6.2f MB   save %8.2f ms %8.1f MB/s   load %8.2f ms %8.1f MB/s\n", label, megabytes,
+           save_ms, megabytes / (save_ms / 1000.0), load_ms, megabytes / (load_ms / 1000.0));
+}
+
+BENCHMARK(data_scene_serialize) {
+    InitializeBenchReflection();
+    const int count = 100000;
+    printf("  %d entities, Transform2D on all (raw), BenchName on 10%% (member by member)\n", count);
+    BenchSceneSerialize(ECS_STORAGE_SPARSE_SET, "sparse set storage", count);
+    BenchSceneSerialize(ECS_STORAGE_ARCHETYPE,  "archetype storage", count);
+}
+
+
+//####################################################################################
+//##    Undo History
+//##        10k small property edits, one transaction each, then every edit undone / redone
+//####################################################################################
+static void BenchUndo(Ecs_Storage storage_mode, const char* label, int edits) {
+    DrCoordinator ecs(storage_mode);
+    BuildScene(ecs, 10000);
+    std::vector<EntityID> named;
+    std::vector<EntityID> transformed;
+    ecs.eachEntity([&](EntityID entity) {
+        transformed.push_back(entity);
+        if (ecs.getEntityType(entity).test(ecs.getComponentID<BenchName>())) named.push_back(entity);
+    });
+
+    // Half the edits go through setMember(), half are made in place after touch() (diffed on commit)
+    DrUndoStack undo(&ecs);
+    size_t memory_start = undo.memoryUsage();
+    DrBenchTimer timer;
+    for (int i = 0; i < edits; ++i) {
+        undo.begin();
+        if (i % 2 == 0) {
+            undo.setMember<BenchName>(named[i % named.size()], "id", i);
+        } else {
+            EntityID entity = transformed[i % transformed.size()];
+            undo.touch(entity, ecs.getComponentID<Transform2D>());
+            ecs.getComponent<Transform2D>(entity).rotation[2] += 0.5;
+        }
+        undo.commit();
+    }
+    double record_ms = timer.ms();
+    size_t memory_growth = undo.memoryUsage() - memory_start;
+    size_t kept = undo.transactionCount();
+
+    timer.restart();
+    while (undo.undo()) { }
+    double undo_ms = timer.ms();
+    timer.restart();
+    while (undo.redo()) { }
+    double redo_ms = timer.ms();
+
+    printf("  %-22s record %6.3f us / edit   memory +%8.1f KB (%5.1f bytes / edit)   undo %6.3f us   redo %6.3f us\n", label,
+           (record_ms * 1000.0) / edits, memory_growth / 1024.0, double(memory_growth) / edits,
+           (undo_ms * 1000.0) / kept, (redo_ms * 1000.0) / kept);
+    if (kept != static_cast<size_t>(edits)) printf("  %-22s (history arena kept %zu of %d transactions)\n", "", kept, edits);
+}
+
+BENCHMARK(data_undo_history) {
+    InitializeBenchReflection();
+    const int edits = 10000;
+    printf("  %d edits on a 10k entity scene, one transaction per edit\n", edits);
+    BenchUndo(ECS_STORAGE_SPARSE_SET, "sparse set storage", edits);
+    BenchUndo(ECS_STORAGE_ARCHETYPE,  "archetype storage", edits);
+}
@@ -0,0 +1,364 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <cmath>
+#include <random>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include "engine/app/core/ThreadPool.h"
+#include "engine/ecs/Coordinator.h"
+#include "Bench.h"
+
+
+//####################################################################################
+//##    Local Structs
+//####################################################################################
+struct BenchPosition {
+    float       x;
+    float       y;
+    float       z;
+};
+struct BenchVelocity {
+    float       x;
+    float       y;
+    float       z;
+};
+struct BenchTag {
+    int         value;
+};
+
+// Distinct System types for benchmarks, 'N' only makes each one a new type
+template <int N>
+class DrBenchSystem : public DrSystem
+{
+public:
+    void init() override { }
+    void update(float) override { }
+};
+
+// Entity IDs 'KEY_START' to 'count', shuffled
+static std::vector<EntityID> ShuffledEntities(int count, unsigned int seed) {
+    std::vector<EntityID> entities(count);
+    for (int i = 0; i < count; ++i) entities[i] = static_cast<EntityID>(i + KEY_START);
+    std::shuffle(entities.begin(), entities.end(), std::mt19937(seed));
+    return entities;
+}
+
+
+//####################################################################################
+//##    Sparse Set Component Storage
+//##        DrComponentArray get / add / remove against the unordered_map index it replaced
+//####################################################################################
+// Map based Component storage DrComponentArray used before the sparse set, kept as a baseline
+template<typename T>
+class DrMapComponentArray
+{
+private:
+    std::vector<T>                              m_component_array   { std::vector<T>(MAX_ENTITIES) };
+    std::unordered_map<EntityID, ArrayIndex>    m_entity_to_index   { };
+    std::unordered_map<ArrayIndex, EntityID>    m_index_to_entity   { };
+    ArrayIndex                                  m_size              { 0 };
+
+public:
+    T& getData(EntityID entity) { return m_component_array[m_entity_to_index[entity]]; }
+
+    void insertData(EntityID entity, T component) {
+        m_entity_to_index[entity] = m_size;
+        m_index_to_entity[m_size] = entity;
+        m_component_array[m_size] = component;
+        ++m_size;
+    }
+
+    void removeData(EntityID entity) {
+        ArrayIndex index_of_removed_entity = m_entity_to_index[entity];
+        ArrayIndex index_of_last_element = m_size - 1;
+        m_component_array[index_of_removed_entity] = m_component_array[index_of_last_element];
+        EntityID entity_of_last_element = m_index_to_entity[index_of_last_element];
+        m_entity_to_index[entity_of_last_element] = index_of_removed_entity;
+        m_index_to_entity[index_of_removed_entity] = entity_of_last_element;
+        m_entity_to_index.erase(entity);
+        m_index_to_entity.erase(index_of_last_element);
+        --m_size;
+    }
+};
+
+// Adds, reads (in random order) and removes 'count' Components, prints millions of operations per second
+template<typename Storage>
+static void BenchComponentStorage(const char* label, int count) {
+    const int get_rounds = 100;
+    std::vector<EntityID> add_order =    ShuffledEntities(count, 1);
+    std::vector<EntityID> get_order =    ShuffledEntities(count, 2);
+    std::vector<EntityID> remove_order = ShuffledEntities(count, 3);
+    double add_ms = 0.0, get_ms = 0.0, remove_ms = 0.0;
+    double sum = 0.0;
+
+    const int runs = 5;
+    for (int run = 0; run < runs; ++run) {
+        std::unique_ptr<Storage> storage(new Storage());
+        DrBenchTimer timer;
+        for (auto entity : add_order) storage->insertData(entity, BenchPosition { 1.f, 2.f, 3.f });
+        double add = timer.ms();
+
+        timer.restart();
+        for (int round = 0; round < get_rounds; ++round) {
+            for (auto entity : get_order) sum += storage->getData(entity).y;
+        }
+        double get = timer.ms();
+
+        timer.restart();
+        for (auto entity : remove_order) storage->removeData(entity);
+        double remove = timer.ms();
+
+        if (run == 0 || add < add_ms)       add_ms = add;
+        if (run == 0 || get < get_ms)       get_ms = get;
+        if (run == 0 || remove < remove_ms) remove_ms = remove;
+    }
+    BenchKeep(sum);
+
+    printf("  %-22s add %8.1f M/s   get %8.1f M/s   remove %8.1f M/s\n", label,
+           (count / 1000.0) / add_ms, (count * get_rounds / 1000.0) / get_ms, (count / 1000.0) / remove_ms);
+}
+
+BENCHMARK(ecs_component_storage) {
+    const int count = 10000;
+    printf("  %d entities, random access order\n", count);
+    BenchComponentStorage<DrMapComponentArray<BenchPosition>>("unordered_map index", count);
+    BenchComponentStorage<DrComponentArray<BenchPosition>>("sparse set", count);
+}
+
+
+//####################################################################################
+//##    System Entity Lists
+//##        Structural change churn, every Entity has a Component added and removed each frame, which moves it
+//##        in / out of half of the Systems. Compared against the std::set membership the Systems used before
+//####################################################################################
+template <int N>
+static void RegisterChurnSystem(DrCoordinator& ecs, bool with_tag) {
+    ecs.registerSystem<DrBenchSystem<N>>();
+    Archetype archetype;
+    archetype.set(ecs.getComponentID<BenchPosition>());
+    if (with_tag) archetype.set(ecs.getComponentID<BenchTag>());
+    ecs.setSystemArchetype<DrBenchSystem<N>>(archetype);
+}
+
+static void BenchSystemChurn(Ecs_Storage storage_mode, const char* label, int count, int frames) {
+    DrCoordinator ecs(storage_mode);
+    ecs.registerComponent<BenchPosition>();
+    ecs.registerComponent<BenchVelocity>();
+    ecs.registerComponent<BenchTag>();
+    RegisterChurnSystem<0>(ecs, false);     RegisterChurnSystem<1>(ecs, true);
+    RegisterChurnSystem<2>(ecs, false);     RegisterChurnSystem<3>(ecs, true);
+    RegisterChurnSystem<4>(ecs, false);     RegisterChurnSystem<5>(ecs, true);
+    RegisterChurnSystem<6>(ecs, false);     RegisterChurnSystem<7>(ecs, true);
+
+    std::vector<EntityID> entities(count);
+    for (auto& entity : entities) {
+        entity = ecs.createEntity();
+        ecs.addComponent(entity, BenchPosition { 0.f, 0.f, 0.f });
+        ecs.addComponent(entity, BenchVelocity { 1.f, 1.f, 1.f });
+    }
+
+    // First frame grows storage, it isn't measured
+    auto frame = [&]() {
+        for (auto entity : entities) ecs.addComponent(entity, BenchTag { 1 });
+        for (auto entity : entities) ecs.removeComponent<BenchTag>(entity);
+    };
+    frame();
+
+    long allocations = BenchAllocations();
+    DrBenchTimer timer;
+    for (int i = 0; i < frames; ++i) frame();
+    double ms = timer.ms();
+    allocations = BenchAllocations() - allocations;
+    printf("  %-22s %8.3f ms / frame   %10.1f allocations / frame\n", label, ms / frames, double(allocations) / frames);
+}
+
+// Same System membership changes made on std::set<EntityID>, one set per System that includes the Tag
+static void BenchSetChurn(int count, int frames) {
+    std::vector<std::set<EntityID>> systems(4);
+    std::vector<EntityID> entities(count);
+    for (int i = 0; i < count; ++i) entities[i] = static_cast<EntityID>(i + KEY_START);
+
+    auto frame = [&]() {
+        for (auto entity : entities) { for (auto& system : systems) system.insert(entity); }
+        for (auto entity : entities) { for (auto& system : systems) system.erase(entity); }
+    };
+    frame();
+
+    long allocations = BenchAllocations();
+    DrBenchTimer timer;
+    for (int i = 0; i < frames; ++i) frame();
+    double ms = timer.ms();
+    allocations = BenchAllocations() - allocations;
+    printf("  %-22s %8.3f ms / frame   %10.1f allocations / frame\n", "std::set (baseline)", ms / frames, double(allocations) / frames);
+}
+
+BENCHMARK(ecs_system_churn) {
+    const int count =  10000;
+    const int frames = 20;
+    printf("  %d entities, 8 systems, tag added / removed on every entity each frame\n", count);
+    BenchSetChurn(count, frames);
+    BenchSystemChurn(ECS_STORAGE_SPARSE_SET, "sparse set storage", count, frames);
+    BenchSystemChurn(ECS_STORAGE_ARCHETYPE,  "archetype storage", count, frames);
+}
+
+
+//####################################################################################
+//##    System Scheduler
+//##        100k Entities, 20 Systems that each read one Component type and write another, frame time of
+//##        DrCoordinator::updateSystems() run serially and on thread pools of increasing size
+//####################################################################################
+template <int N>
+struct BenchData {
+    float       value[4];
+};
+
+// Writes Component 'W' from Component 'R' of every Entity it has
+template <int N, int R, int W>
+class DrWorkSystem : public DrSystem
+{
+public:
+    DrCoordinator*  ecs     { nullptr };
+
+    void init() override { }
+    void update(float dt) override {
+        for (auto entity : m_entities) {
+            const BenchData<R>& read =  ecs->getComponent<BenchData<R>>(entity);
+            BenchData<W>& write =       ecs->getComponent<BenchData<W>>(entity);
+            for (int i = 0; i < 4; ++i) write.value[i] = std::sqrt(write.value[i] * write.value[i] + read.value[i] * dt);
+        }
+    }
+};
+
+template <int N, int R, int W>
+static void RegisterWorkSystem(DrCoordinator& ecs) {
+    std::shared_ptr<DrWorkSystem<N, R, W>> system = ecs.registerSystem<DrWorkSystem<N, R, W>>();
+    system->ecs = &ecs;
+    Archetype read, write;
+    read.set(ecs.getComponentID<BenchData<R>>());
+    write.set(ecs.getComponentID<BenchData<W>>());
+    ecs.setSystemArchetype<DrWorkSystem<N, R, W>>(read | write);
+    ecs.setSystemAccess<DrWorkSystem<N, R, W>>(read, write);
+}
+
+template <int N>
+static void AddBenchData(DrCoordinator& ecs, EntityID entity) {
+    ecs.addComponent(entity, BenchData<N> { { 1.f, 2.f, 3.f, 4.f } });
+}
+
+static void BenchScheduler(Ecs_Storage storage_mode, const char* label, int count) {
+    DrCoordinator ecs(storage_mode);
+    ecs.registerComponent<BenchData<0>>();  ecs.registerComponent<BenchData<1>>();
+    ecs.registerComponent<BenchData<2>>();  ecs.registerComponent<BenchData<3>>();
+    ecs.registerComponent<BenchData<4>>();  ecs.registerComponent<BenchData<5>>();
+    ecs.registerComponent<BenchData<6>>();  ecs.registerComponent<BenchData<7>>();
+
+    // Systems 0-9 read 4-7 and write 0-3, Systems 10-19 read 0-3 and write 4-7
+    RegisterWorkSystem< 0, 4, 0>(ecs);  RegisterWorkSystem< 1, 5, 1>(ecs);  RegisterWorkSystem< 2, 6, 2>(ecs);
+    RegisterWorkSystem< 3, 7, 3>(ecs);  RegisterWorkSystem< 4, 5, 0>(ecs);  RegisterWorkSystem< 5, 6, 1>(ecs);
+    RegisterWorkSystem< 6, 7, 2>(ecs);  RegisterWorkSystem< 7, 4, 3>(ecs);  RegisterWorkSystem< 8, 6, 0>(ecs);
+    RegisterWorkSystem< 9, 7, 1>(ecs);  RegisterWorkSystem<10, 0, 4>(ecs);  RegisterWorkSystem<11, 1, 5>(ecs);
+    RegisterWorkSystem<12, 2, 6>(ecs);  RegisterWorkSystem<13, 3, 7>(ecs);  RegisterWorkSystem<14, 1, 4>(ecs);
+    RegisterWorkSystem<15, 2, 5>(ecs);  RegisterWorkSystem<16, 3, 6>(ecs);  RegisterWorkSystem<17, 0, 7>(ecs);
+    RegisterWorkSystem<18, 2, 4>(ecs);  RegisterWorkSystem<19, 3, 5>(ecs);
+
+    for (int i = 0; i < count; ++i) {
+        EntityID entity = ecs.createEntity();
+        AddBenchData<0>(ecs, entity);   AddBenchData<1>(ecs, entity);   AddBenchData<2>(ecs, entity);
+        AddBenchData<3>(ecs, entity);   AddBenchData<4>(ecs, entity);   AddBenchData<5>(ecs, entity);
+        AddBenchData<6>(ecs, entity);   AddBenchData<7>(ecs, entity);
+    }
+
+    const int frames = 10;
+    int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    printf("  %s\n", label);
+    double serial = BenchBest(frames, [&]() { ecs.updateSystems(1.f / 60.f); });
+    printf("    %-16s %8.2f ms / frame\n", "serial", serial);
+    for (int workers = 1; workers <= std::max(4, hardware_threads); workers *= 2) {
+        DrThreadPool pool(workers);
+        double time = BenchBest(frames, [&]() { ecs.updateSystems(1.f / 60.f, &pool); });
+        printf("    %2d worker%s       %8.2f ms / frame   %5.2fx\n", workers, (workers == 1) ? " " : "s", time, serial / time);
+    }
+}
+
+BENCHMARK(ecs_system_scheduler) {
+    const int count = 100000;
+    printf("  %d entities, 8 components each, 20 systems, %u hardware threads\n", count, std::thread::hardware_concurrency());
+    BenchScheduler(ECS_STORAGE_SPARSE_SET, "sparse set storage", count);
+    BenchScheduler(ECS_STORAGE_ARCHETYPE,  "archetype storage", count);
+}
+
+
+//####################################################################################
+//##    Snapshot / Restore
+//##        Play-in-editor round trip of a 50k Entity scene, save snapshot, change scene, restore it
+//####################################################################################
+static void BenchSnapshot(Ecs_Storage storage_mode, const char* label, int count) {
+    DrCoordinator ecs(storage_mode);
+    ecs.registerComponent<BenchPosition>();
+    ecs.registerComponent<BenchVelocity>();
+    ecs.registerComponent<BenchTag>();
+    RegisterChurnSystem<0>(ecs, false);     RegisterChurnSystem<1>(ecs, true);
+    RegisterChurnSystem<2>(ecs, false);     RegisterChurnSystem<3>(ecs, true);
+
+    std::vector<EntityID> entities(count);
+    for (int i = 0; i < count; ++i) {
+        entities[i] = ecs.createEntity();
+        ecs.addComponent(entities[i], BenchPosition { 0.f, 0.f, 0.f });
+        ecs.addComponent(entities[i], BenchVelocity { 1.f, 1.f, 1.f });
+        if (i % 2 == 0) ecs.addComponent(entities[i], BenchTag { i });
+    }
+
+    // Frame of play mode work, moves every Entity
+    auto frame = [&]() {
+        for (auto entity : entities) {
+            if (ecs.isAlive(entity) == false) continue;
+            BenchPosition& position = ecs.getComponent<BenchPosition>(entity);
+            const BenchVelocity& velocity = ecs.getComponent<BenchVelocity>(entity);
+            position.x += velocity.x;   position.y += velocity.y;   position.z += velocity.z;
+        }
+    };
+    double frame_ms = BenchBest(10, frame);
+
+    // Play mode changes, destroys 10% of Entities, tags the rest
+    auto play = [&]() {
+        for (int i = 0; i < count; ++i) {
+            if (i % 10 == 0) { ecs.destroyEntity(entities[i]); continue; }
+            if (i % 2 == 1) ecs.addComponent(entities[i], BenchTag { i });
+        }
+        frame();
+    };
+
+    DrEcsSnapshot snapshot;
+    double save_ms = 0.0, restore_ms = 0.0, frame_held_ms = 0.0;
+    const int runs = 5;
+    for (int run = 0; run < runs; ++run) {
+        DrBenchTimer timer;
+        ecs.saveSnapshot(snapshot);
+        double save = timer.ms();
+        if (run == 0) frame_held_ms = BenchBest(10, frame);
+        play();
+
+        timer.restart();
+        ecs.restoreSnapshot(snapshot);
+        double restore = timer.ms();
+        if (run == 0 || save < save_ms)       save_ms = save;
+        if (run == 0 || restore < restore_ms) restore_ms = restore;
+    }
+    printf("  %-22s save %6.2f ms   restore %6.2f ms   frame %6.3f ms (%6.3f ms with snapshot held)\n", label,
+           save_ms, restore_ms, frame_ms, frame_held_ms);
+}
+
+BENCHMARK(ecs_snapshot) {
+    const int count = 50000;
+    printf("  %d entities, 2-3 components each, 4 systems, 10%% destroyed / 50%% tagged between save and restore\n", count);
+    BenchSnapshot(ECS_STORAGE_SPARSE_SET, "sparse set storage", count);
+    BenchSnapshot(ECS_STORAGE_ARCHETYPE,  "archetype storage", count);
+}
@@ -0,0 +1,27 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+
+//####################################################################################
+//##
+//##    Single Header Library Initialization (benchmarks only, see build_headers.c for the app)
+//##
+//####################################################################################
+#define STB_IMAGE_IMPLEMENTATION
+#include "3rd_party/stb/stb_image.h"
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "3rd_party/stb/stb_image_resize.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "3rd_party/stb/stb_image_write.h"
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "3rd_party/stb/stb_rect_pack.h"
+
+#define HANDMADE_MATH_IMPLEMENTATION
+#define HANDMADE_MATH_NO_SSE
+#include "3rd_party/handmade_math.h"
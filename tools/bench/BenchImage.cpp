@@ -0,0 +1,435 @@
+/** /////////////////////////////////////////////////////////////////////////////////
+//
+// @description Eyedrop
+// @about       C++ game engine built on Sokol
+// @author      Stephens Nunnally <@stevinz>
+// @license     MIT - Copyright (c) 2021 Stephens Nunnally and Scidian Studios
+// @source      https://github.com/scidian/eyedrop
+//
+///////////////////////////////////////////////////////////////////////////////////*/
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+#include "3rd_party/stb/stb_image_write.h"
+#include "3rd_party/stb/stb_rect_pack.h"
+#include "engine/app/core/Math.h"
+#include "engine/app/core/ThreadPool.h"
+#include "engine/app/geometry/Point.h"
+#include "engine/app/image/Bitmap.h"
+#include "engine/app/image/Color.h"
+#include "engine/app/image/Filter.h"
+#include "engine/app/image/FilterKernels.h"
+#include "engine/app/image/FilterPipeline.h"
+#include "engine/app/image/RowBands.h"
+#include "engine/app/resources/AtlasPacker.h"
+#include "engine/data/Constants.h"
+#include "Bench.h"
+
+
+//####################################################################################
+//##    Local Functions
+//####################################################################################
+// Random BGRA pixels
+static std::vector<unsigned char> RandomPixels(int width, int height, unsigned int seed) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+    std::mt19937 random(seed);
+    for (auto& byte : pixels) byte = static_cast<unsigned char>(random() & 255);
+    return pixels;
+}
+
+
+//####################################################################################
+//##    Per Pixel Filters
+//##        FilterPixels() kernels against the DrColor per pixel path DrFilter::applySinglePixelFilter used before
+//####################################################################################
+// Per pixel filter path used before FilterKernels, kept as a baseline
+static void FilterPixelsDrColor(Image_Filter_Type filter, std::vector<unsigned char>& bgra, int value) {
+    int table[256];
+    for (int i = 0; i < 256; ++i) {
+        if (filter == DROP_IMAGE_FILTER_BRIGHTNESS) table[i] = Clamp(i + value, 0, 255);
+        if (filter == DROP_IMAGE_FILTER_CONTRAST)   table[i] = Clamp(((i - 127) * (value + 128) / 128) + 127, 0, 255);
+    }
+    for (size_t i = 0; i < bgra.size(); i += 4) {
+        DrColor color(bgra[i + 2], bgra[i + 1], bgra[i], bgra[i + 3]);
+        switch (filter) {
+            case DROP_IMAGE_FILTER_BRIGHTNESS:
+            case DROP_IMAGE_FILTER_CONTRAST:
+                color.setRed(table[color.red()]);
+                color.setGreen(table[color.green()]);
+                color.setBlue(table[color.blue()]);
+                break;
+            case DROP_IMAGE_FILTER_GRAYSCALE: {
+                double gray = (color.redF() * 0.2126) + (color.greenF() * 0.7152) + (color.blueF() * 0.0722);
+                color.setRgbF(gray, gray, gray, color.alphaF());
+                break;
+            }
+            case DROP_IMAGE_FILTER_NEGATIVE:
+                color.setRgbF(1.0 - color.redF(), 1.0 - color.greenF(), 1.0 - color.blueF(), color.alphaF());
+                break;
+            case DROP_IMAGE_FILTER_OPACITY:
+                color.setAlpha(Clamp(color.alpha() + value, 0, 255));
+                break;
+            case DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA:
+                color.setRedF(color.redF() * color.alphaF());
+                color.setGreenF(color.greenF() * color.alphaF());
+                color.setBlueF(color.blueF() * color.alphaF());
+                break;
+            default: ;
+        }
+        bgra[i] = color.blue();     bgra[i + 1] = color.green();    bgra[i + 2] = color.red();  bgra[i + 3] = color.alpha();
+    }
+}
+
+BENCHMARK(image_filter_kernels) {
+    const int width = 2048, height = 2048;
+    const double megapixels = (static_cast<double>(width) * height) / 1000000.0;
+    const std::vector<unsigned char> source = RandomPixels(width, height, 7);
+
+    const Image_Filter_Type filters[] = { DROP_IMAGE_FILTER_BRIGHTNESS, DROP_IMAGE_FILTER_CONTRAST, DROP_IMAGE_FILTER_GRAYSCALE,
+                                          DROP_IMAGE_FILTER_NEGATIVE, DROP_IMAGE_FILTER_OPACITY, DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA };
+    const char* names[] = { "brightness", "contrast", "grayscale", "negative", "opacity", "premultiply" };
+    Filter_Isa best = BestFilterIsa();
+
+    printf("  %dx%d BGRA, megapixels / second, best instruction set on this cpu: %s\n", width, height,
+           (best == DROP_FILTER_ISA_AVX2) ? "avx2" : (best == DROP_FILTER_ISA_SSE2) ? "sse2" : "scalar");
+    printf("  %-14s %10s %10s %10s %10s\n", "", "DrColor", "scalar", "sse2", "avx2");
+    for (int f = 0; f < 6; ++f) {
+        std::vector<unsigned char> pixels = source;
+        double baseline = BenchBest(3, [&]() { FilterPixelsDrColor(filters[f], pixels, 20); });
+        printf("  %-14s %10.1f", names[f], megapixels / (baseline / 1000.0));
+        for (int isa = DROP_FILTER_ISA_SCALAR; isa <= DROP_FILTER_ISA_AVX2; ++isa) {
+            if (isa > best) { printf(" %10s", "n/a"); continue; }
+            pixels = source;
+            double time = BenchBest(3, [&]() { FilterPixels(filters[f], pixels.data(), pixels.size() / 4, 20, static_cast<Filter_Isa>(isa)); });
+            printf(" %10.1f", megapixels / (time / 1000.0));
+        }
+        printf("\n");
+    }
+}
+
+
+//####################################################################################
+//##    Row Band Threading
+//##        Bitmap filters / conversions on a 4096x4096 image, serial and split into row bands across
+//##        thread pools of increasing size (output is checked to match serial)
+//####################################################################################
+BENCHMARK(image_row_bands) {
+    const int size = 4096;
+    DrBitmap source(size, size);
+    source.data = RandomPixels(size, size, 5);
+
+    struct BenchOp {
+        const char*                                 name;
+        std::function<std::vector<unsigned char>()> run;
+    };
+    std::vector<BenchOp> ops = {
+        { "brightness",     [&]() { return DrFilter::applySinglePixelFilter(DROP_IMAGE_FILTER_BRIGHTNESS, source, 30).data; } },
+        { "premultiply",    [&]() { return DrFilter::applySinglePixelFilter(DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA, source, 0).data; } },
+        { "black_white",    [&]() { return DrFilter::blackAndWhiteFromAlpha(source, 0.5, true).data; } },
+        { "to_grayscale",   [&]() { return DrBitmap(source, DROP_BITMAP_FORMAT_GRAYSCALE).data; } },
+        { "saveFormat",     [&]() { std::vector<unsigned char> formatted; source.saveFormat(formatted); return formatted; } },
+        { "fuzzyAlpha",     [&]() { DrBitmap copy = source; copy.fuzzyAlpha(); return copy.data; } },
+    };
+    const int thread_counts[] = { 1, 2, 4, 8 };
+
+    printf("  %dx%d, best of 3 (ms), %u hardware threads\n", size, size, std::thread::hardware_concurrency());
+    printf("  %-14s %9s", "", "serial");
+    for (int threads : thread_counts) printf("  %5d thr", threads);
+    printf("\n");
+    for (auto& op : ops) {
+        SetImageThreadPool(nullptr);
+        std::vector<unsigned char> expected;
+        double serial = BenchBest(3, [&]() { expected = op.run(); });
+        printf("  %-14s %9.1f", op.name, serial);
+        for (int threads : thread_counts) {
+            DrThreadPool pool(threads - 1);                                         // Calling thread helps run row bands
+            SetImageThreadPool(&pool);
+            std::vector<unsigned char> result;
+            double time = BenchBest(3, [&]() { result = op.run(); });
+            SetImageThreadPool(nullptr);
+            assert(result == expected && "Row band output does not match serial output!");
+            printf("  %9.1f", time);
+        }
+        printf("\n");
+    }
+}
+
+
+//####################################################################################
+//##    Flood Fill
+//##        Scanline DrFilter::floodFill() against the point list flood it replaced, then fill / object
+//##        finding on 2048x2048 sprites of ring shaped objects on a transparent background
+//####################################################################################
+// Point list flood fill DrFilter::floodFill used before the scanline fill, kept as a baseline
+static int FloodFillPointList(DrBitmap& bitmap, int at_x, int at_y, DrColor fill_color, double tolerance, Flood_Fill_Type type) {
+    const int not_processed = 0, was_processed = 1, marked_for_process = 2;
+    DrBitmap processed(bitmap);
+    for (int x = 0; x < bitmap.width; ++x) {
+        for (int y = 0; y < bitmap.height; ++y) {
+            processed.setPixel(x, y, not_processed);
+        }
+    }
+    DrColor start_color = bitmap.getPixel(at_x, at_y);
+    int flood_pixel_count = 0;
+
+    std::vector<DrPoint> points { DrPoint(at_x, at_y) };
+    bool processed_some;
+    do {
+        processed_some = false;
+        for (size_t p = 0; p < points.size(); ++p) {
+            DrPoint point = points[p];
+            if (processed.getPixel(point.x, point.y) == was_processed) continue;
+            bitmap.setPixel(point.x, point.y, fill_color);
+            processed.setPixel(point.x, point.y, was_processed);
+            ++flood_pixel_count;
+            for (int x = std::max(point.x - 1, 0); x <= std::min(point.x + 1, bitmap.width - 1); ++x) {
+                for (int y = std::max(point.y - 1, 0); y <= std::min(point.y + 1, bitmap.height - 1); ++y) {
+                    if (x == point.x && y == point.y) continue;
+                    if (type == DROP_FLOOD_FILL_COMPARE_4 && x != point.x && y != point.y) continue;
+                    if (processed.getPixel(x, y) == not_processed && IsSameColor(start_color, bitmap.getPixel(x, y), tolerance)) {
+                        points.push_back(DrPoint(x, y));
+                        processed.setPixel(x, y, marked_for_process);
+                        processed_some = true;
+                    }
+                }
+            }
+        }
+        auto it = points.begin();
+        while (it != points.end()) {
+            if (processed.getPixel(it->x, it->y) == was_processed) it = points.erase(it); else ++it;
+        }
+    } while (points.size() > 0 && processed_some);
+    return flood_pixel_count;
+}
+
+// Transparent sprite with a grid of opaque rings, each ring has a transparent hole
+static DrBitmap RingSprite(int size, int cell) {
+    DrBitmap sprite(size, size);
+    const double outer = cell * 0.4, inner = cell * 0.15;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            double dx = (x % cell) - cell * 0.5 + 0.5;
+            double dy = (y % cell) - cell * 0.5 + 0.5;
+            double distance = std::sqrt(dx*dx + dy*dy);
+            sprite.setPixel(x, y, (distance < outer && distance > inner) ? DROP_COLOR_WHITE : DROP_COLOR_TRANSPARENT);
+        }
+    }
+    return sprite;
+}
+
+BENCHMARK(image_flood_fill) {
+    // Scanline fill against the point list fill, background of each sprite from the top left corner
+    printf("  floodFill of background (ms)\n");
+    printf("  %-10s %-9s %12s %12s %10s %10s\n", "sprite", "compare", "pixels", "point list", "scanline", "speedup");
+    for (int size : { 64, 128, 256 }) {
+        const DrBitmap sprite = RingSprite(size, 64);
+        for (Flood_Fill_Type type : { DROP_FLOOD_FILL_COMPARE_4, DROP_FLOOD_FILL_COMPARE_8 }) {
+            int baseline_count = 0, count = 0;
+            DrRect rect;
+            DrBitmap baseline_bitmap, bitmap;
+            double baseline = BenchBest(1, [&]() {
+                baseline_bitmap = sprite;
+                baseline_count = FloodFillPointList(baseline_bitmap, 0, 0, DROP_COLOR_RED, 0.001, type);
+            });
+            double scanline = BenchBest(3, [&]() {
+                bitmap = sprite;
+                DrFilter::floodFill(bitmap, 0, 0, DROP_COLOR_RED, 0.001, type, count, rect);
+            });
+            assert(count == baseline_count && bitmap.data == baseline_bitmap.data && "Scanline fill does not match point list fill!");
+            printf("  %4dx%-5d %-9s %12d %12.2f %10.2f %9.0fx\n", size, size, (type == DROP_FLOOD_FILL_COMPARE_4) ? "4 way" : "8 way",
+                   count, baseline, scanline, baseline / scanline);
+        }
+    }
+
+    // Fill and object finding at full sprite size
+    const int size = 2048;
+    for (int cell : { 256, 64, 16 }) {
+        const DrBitmap sprite = RingSprite(size, cell);
+        int count = 0;
+        DrRect rect;
+        DrBitmap bitmap;
+        double flood = BenchBest(3, [&]() {
+            bitmap = sprite;
+            DrFilter::floodFill(bitmap, 0, 0, DROP_COLOR_RED, 0.001, DROP_FLOOD_FILL_COMPARE_4, count, rect);
+        });
+        double border = BenchBest(3, [&]() {
+            bitmap = sprite;
+            DrFilter::fillBorder(bitmap, DROP_COLOR_RED, bitmap.rect());
+        });
+        DrObjectLabels labels;
+        double label = BenchBest(3, [&]() { DrFilter::labelObjects(sprite, labels, 0.5); });
+        std::vector<DrBitmap> bitmaps;
+        std::vector<DrRect> rects;
+        double find = BenchBest(3, [&]() {
+            bitmaps.clear();
+            rects.clear();
+            DrFilter::findObjectsInBitmap(sprite, bitmaps, rects, 0.5);
+        });
+        printf("  %dx%d, %5d rings: floodFill %7.2f ms, fillBorder %7.2f ms, labelObjects %7.2f ms, findObjectsInBitmap %7.2f ms (%zu objects)\n",
+               size, size, (size / cell) * (size / cell), flood, border, label, find, bitmaps.size());
+    }
+}
+
+
+//####################################################################################
+//##    Batch Import
+//##        CPU side of DrImageManager::loadImages(), 1,000 png files are decoded and premultiplied one after
+//##        another (as each fetch used to be), then split across thread pools with DrThreadPool::parallelFor()
+//####################################################################################
+BENCHMARK(image_batch_import) {
+    // Encode sprites (64 to 256 pixels square, gradient filled rings) to png files in memory
+    const int image_count = 1000;
+    std::vector<std::vector<unsigned char>> files(image_count);
+    std::mt19937 random(11);
+    size_t file_bytes = 0, pixel_count = 0;
+    for (auto& file : files) {
+        int size = 64 + static_cast<int>(random() % 193);
+        DrBitmap sprite = RingSprite(size, size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (sprite.getPixel(x, y).alpha() == 0) continue;
+                sprite.setPixel(x, y, DrColor((x * 255) / size, (y * 255) / size, 128, 192));
+            }
+        }
+        stbi_write_png_to_func([](void* context, void* data, int size) {
+            auto bytes = static_cast<std::vector<unsigned char>*>(context);
+            bytes->insert(bytes->end(), static_cast<unsigned char*>(data), static_cast<unsigned char*>(data) + size);
+        }, &file, size, size, 4, sprite.data.data(), size * 4);
+        file_bytes += file.size();
+        pixel_count += static_cast<size_t>(size) * size;
+    }
+
+    // Same work per image as DrImageManager::createImage()
+    const DrFilterPipeline premultiply = DrFilterPipeline().add(DROP_IMAGE_FILTER_PREMULTIPLIED_ALPHA);
+    std::vector<DrBitmap> bitmaps(image_count);
+    auto work = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            bitmaps[i] = DrBitmap(files[i].data(), static_cast<int>(files[i].size()));
+            premultiply.apply(bitmaps[i]);
+        }
+    };
+
+    printf("  %d png files, %.1f MB compressed, %.1f MP decoded, best of 3, %u hardware threads\n", image_count,
+           file_bytes / (1024.0 * 1024.0), pixel_count / 1000000.0, std::thread::hardware_concurrency());
+    SetImageThreadPool(nullptr);
+    double serial = BenchBest(3, [&]() { work(0, image_count); });
+    std::vector<DrBitmap> expected = bitmaps;
+    printf("  %-10s %9.1f ms %8.1f images / s\n", "serial", serial, image_count / (serial / 1000.0));
+    for (int threads : { 1, 2, 4, 8 }) {
+        DrThreadPool pool(threads - 1);                                             // Calling thread helps decode
+        double time = BenchBest(3, [&]() { pool.parallelFor(image_count, 1, work); });
+        for (int i = 0; i < image_count; ++i) {
+            assert(bitmaps[i].data == expected[i].data && "Parallel import does not match serial import!");
+        }
+        printf("  %2d threads %9.1f ms %8.1f images / s\n", threads, time, image_count / (time / 1000.0));
+    }
+}
+
+
+//####################################################################################
+//##    Atlas Packing
+//##        Images added to a multi image atlas one at a time through DrAtlasPacker (the cpu side of
+//##        DrImageManager::addImageToAtlas()), against the path it replaced, which repacked every rect and
+//##        re-blit every image onto a new bitmap (then re-created the gpu texture) on each insert
+//####################################################################################
+// Atlas packing DrImageManager used before DrAtlasPacker, kept as a baseline, returns bytes uploaded to gpu
+static size_t RepackAllAtlas(const std::vector<DrBitmap>& images, int padding, int start_size, int max_size, int& atlas_size) {
+    size_t upload_bytes = 0;
+    atlas_size = start_size;
+    std::vector<stbrp_rect> rects;
+    int pixels_used = 0;
+    for (size_t added = 0; added < images.size(); ++added) {
+        const DrBitmap& image = images[added];
+        rects.resize(added + 1);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            rects[i].id = static_cast<int>(i);
+            rects[i].w =  images[i].width  + padding*2;
+            rects[i].h =  images[i].height + padding*2;
+        }
+        auto pack_all = [&rects](int size) {
+            std::vector<stbrp_node> nodes(static_cast<size_t>(size) * 2);
+            stbrp_context context;
+            stbrp_init_target(&context, size, size, &nodes[0], static_cast<int>(nodes.size()));
+            return stbrp_pack_rects(&context, &rects[0], static_cast<int>(rects.size())) == 1;
+        };
+
+        // Full repack at current size, or grow once and repack
+        bool packed = false;
+        if ((image.width + padding) * (image.height + padding) <= (atlas_size * atlas_size) - pixels_used) packed = pack_all(atlas_size);
+        if (packed == false) {
+            int atlas_x2 =  atlas_size * 2;
+            int min_dimen = atlas_size + image.minDimension();
+            int max_dimen = image.maxDimension();
+            int size_needed = ((min_dimen <= atlas_x2) && (max_dimen <= atlas_x2)) ? Max(min_dimen, max_dimen) : atlas_size + max_dimen;
+            if (size_needed > max_size) break;
+            atlas_size = RoundPowerOf2(size_needed);
+            pack_all(atlas_size);
+        }
+        pixels_used = 0;
+        for (auto& rect : rects) pixels_used += rect.w * rect.h;
+
+        // New atlas bitmap, every image blit onto it, whole texture re-created
+        DrBitmap bitmap(atlas_size, atlas_size, DROP_BITMAP_FORMAT_ARGB);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            DrRect  source_rect = images[i].rect();
+            DrPoint dest_point(rects[i].x + padding, rects[i].y + padding);
+            DrBitmap::Blit(images[i], source_rect, bitmap, dest_point);
+        }
+        upload_bytes += bitmap.data.size();
+    }
+    return upload_bytes;
+}
+
+BENCHMARK(image_atlas_packing) {
+    const int padding = 1;
+    const int start_size = 512;
+    const int max_size = MAX_ATLAS_SIZE;
+    printf("  images 16 to 64 pixels square, atlas starts at %dx%d\n", start_size, start_size);
+    printf("  repack all uploads the whole atlas on every insert, DrAtlasPacker's shadow copy is uploaded whole once per frame\n");
+    printf("  %7s %11s %14s %17s %9s %20s %20s\n", "images", "atlas", "repack all ms", "DrAtlasPacker ms", "speedup",
+           "repack all upload MB", "packer MB / frame");
+    for (int image_count : { 100, 250, 500 }) {
+        std::mt19937 random(13);
+        std::vector<DrBitmap> images(image_count);
+        for (int i = 0; i < image_count; ++i) {
+            DrBitmap image(16 + static_cast<int>(random() % 49), 16 + static_cast<int>(random() % 49));
+            image.data = RandomPixels(image.width, image.height, static_cast<unsigned int>(i));
+            images[i].swap(image);
+        }
+
+        // Baseline, one texture re-created per insert
+        int old_size = 0;
+        size_t old_upload = 0;
+        double baseline = BenchBest(1, [&]() { old_upload = RepackAllAtlas(images, padding, start_size, max_size, old_size); });
+
+        // DrAtlasPacker, shadow copy is uploaded whole once per frame (all images added in one frame here)
+        std::shared_ptr<DrAtlasPacker> packer;
+        int grew = 0;
+        double incremental = BenchBest(3, [&]() {
+            packer = std::make_shared<DrAtlasPacker>(start_size);
+            grew = 0;
+            for (int i = 0; i < image_count; ++i) {
+                Atlas_Pack_Result result = packer->add(i, images[i], padding, max_size);
+                assert(result != ATLAS_PACK_FAILED && "Image did not fit on atlas!");
+                if (result == ATLAS_PACK_GREW) ++grew;
+            }
+        });
+        size_t frame_upload = packer->shadow().data.size();
+
+        // Every image must end up where its rect says
+        for (const DrAtlasSlot& slot : packer->slots()) {
+            const DrBitmap& image = images[slot.key];
+            for (int y = 0; y < image.height; ++y) {
+                for (int x = 0; x < image.width; ++x) {
+                    assert(packer->shadow().getPixel(slot.rect.x + padding + x, slot.rect.y + padding + y) == image.getPixel(x, y) &&
+                           "Atlas pixels do not match packed image!");
+                }
+            }
+        }
+        printf("  %7d %5dx%-5d %14.2f %17.2f %8.0fx %20.1f %20.1f  (grew %d times)\n",
+               image_count, packer->size(), packer->size(), baseline, incremental, baseline / incremental,
+               old_upload / (1024.0 * 1024.0), frame_upload / (1024.0 * 1024.0), grew);
+    }
+}